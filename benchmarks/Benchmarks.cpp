@@ -0,0 +1,336 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include "Sequence.hpp"
+#include "DynamicArray.hpp"
+#include "ArraySequence.hpp"
+#include "ListSequence.hpp"
+#include "ImmutableArraySequence.hpp"
+#include "ImmutableListSequence.hpp"
+#include "SequencePairOperations.hpp"
+#include "PerfCounters.hpp"
+
+// Запуск с JSON-выводом для сравнения между релизами:
+//   ./Benchmarks --benchmark_out=bench.json --benchmark_out_format=json
+// Аппаратные счётчики (циклы, инструкции, промахи кэшей и ветвлений):
+//   ./Benchmarks --perf_counters
+
+namespace {
+
+int square(const int& x) { return x * x; }
+bool isEven(const int& x) { return x % 2 == 0; }
+int add(const int& a, const int& b) { return a + b; }
+
+void doubleIntoSink(const int& x, ISequenceSink<int>& sink) {
+    sink.Push(x);
+    sink.Push(x);
+}
+
+template <typename S>
+constexpr bool IsImmutable = std::is_same<S, ImmutableArraySequence<int>>::value
+                          || std::is_same<S, ImmutableListSequence<int>>::value;
+
+template <typename S>
+constexpr bool IsList = std::is_base_of<ListSequence<int>, S>::value;
+
+DynamicArray<int> MakeItems(int count) {
+    DynamicArray<int> items(count);
+    std::uint32_t state = 12345;
+    for (int i = 0; i < count; ++i) {
+        state = state * 1664525u + 1013904223u;
+        items[i] = static_cast<int>(state >> 8) - (1 << 23);
+    }
+    return items;
+}
+
+template <typename S>
+S MakeSequence(int count) {
+    DynamicArray<int> items = MakeItems(count);
+    return S(items.GetData(), count);
+}
+
+void SetThroughput(benchmark::State& state, std::int64_t itemsPerIteration) {
+    state.SetItemsProcessed(state.iterations() * itemsPerIteration);
+    state.SetBytesProcessed(state.iterations() * itemsPerIteration * static_cast<std::int64_t>(sizeof(int)));
+}
+
+// Полный диапазон 1e2..1e7 для линейных операций
+void LinearSizes(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(10)->Range(100, 10000000)->Unit(benchmark::kMicrosecond);
+}
+
+// Операции, квадратичные по природе (сдвиги массива, обход списка по индексу),
+// ограничены 1e5, чтобы прогон оставался разумным по времени.
+void QuadraticSizes(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMicrosecond);
+}
+
+template <typename S>
+void BM_Append(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    if constexpr (IsImmutable<S>) {
+        S base = MakeSequence<S>(count);
+        PerfCountersScope perfCounters(state);
+        for (auto _ : state) {
+            auto* result = base.AppendNew(1);
+            benchmark::DoNotOptimize(result);
+            delete result;
+        }
+        SetThroughput(state, count);
+    } else {
+        PerfCountersScope perfCounters(state);
+        for (auto _ : state) {
+            S seq;
+            for (int i = 0; i < count; ++i) {
+                seq.Append(i);
+            }
+            benchmark::DoNotOptimize(seq.GetLength());
+        }
+        SetThroughput(state, count);
+    }
+}
+
+template <typename S>
+void BM_Prepend(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    if constexpr (IsImmutable<S>) {
+        S base = MakeSequence<S>(count);
+        PerfCountersScope perfCounters(state);
+        for (auto _ : state) {
+            auto* result = base.PrependNew(1);
+            benchmark::DoNotOptimize(result);
+            delete result;
+        }
+    } else {
+        PerfCountersScope perfCounters(state);
+        for (auto _ : state) {
+            S seq;
+            for (int i = 0; i < count; ++i) {
+                seq.Prepend(i);
+            }
+            benchmark::DoNotOptimize(seq.GetLength());
+        }
+    }
+    SetThroughput(state, count);
+}
+
+template <typename S>
+void BM_InsertAt(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    S base = MakeSequence<S>(count);
+    PerfCountersScope perfCounters(state);
+    for (auto _ : state) {
+        if constexpr (IsImmutable<S>) {
+            auto* result = base.InsertAtNew(1, count / 2);
+            benchmark::DoNotOptimize(result);
+            delete result;
+        } else {
+            perfCounters.PauseTiming();
+            S seq(base);
+            perfCounters.ResumeTiming();
+            seq.InsertAt(1, count / 2);
+            benchmark::DoNotOptimize(seq.GetLength());
+        }
+    }
+    SetThroughput(state, count);
+}
+
+template <typename S>
+void BM_Get(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    S seq = MakeSequence<S>(count);
+    PerfCountersScope perfCounters(state);
+    for (auto _ : state) {
+        long long sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += seq.Get(i);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    SetThroughput(state, count);
+}
+
+template <typename S>
+void BM_Enumerate(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    S seq = MakeSequence<S>(count);
+    PerfCountersScope perfCounters(state);
+    for (auto _ : state) {
+        long long sum = 0;
+        IEnumerator<int>* enumerator = seq.GetEnumerator();
+        while (enumerator->MoveNext()) {
+            sum += enumerator->Current();
+        }
+        delete enumerator;
+        benchmark::DoNotOptimize(sum);
+    }
+    SetThroughput(state, count);
+}
+
+template <typename S>
+void BM_Map(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    S seq = MakeSequence<S>(count);
+    PerfCountersScope perfCounters(state);
+    for (auto _ : state) {
+        Sequence<int>* result = seq.Map(square);
+        benchmark::DoNotOptimize(result);
+        delete result;
+    }
+    SetThroughput(state, count);
+}
+
+template <typename S>
+void BM_Where(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    S seq = MakeSequence<S>(count);
+    PerfCountersScope perfCounters(state);
+    for (auto _ : state) {
+        Sequence<int>* result = seq.Where(isEven);
+        benchmark::DoNotOptimize(result);
+        delete result;
+    }
+    SetThroughput(state, count);
+}
+
+template <typename S>
+void BM_Reduce(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    S seq = MakeSequence<S>(count);
+    PerfCountersScope perfCounters(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(seq.Reduce(add, 0));
+    }
+    SetThroughput(state, count);
+}
+
+template <typename S>
+void BM_Concat(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    S first = MakeSequence<S>(count);
+    S second = MakeSequence<S>(count);
+    PerfCountersScope perfCounters(state);
+    for (auto _ : state) {
+        Sequence<int>* result = first.Concat(&second);
+        benchmark::DoNotOptimize(result);
+        delete result;
+    }
+    SetThroughput(state, 2LL * count);
+}
+
+template <typename S>
+void BM_Slice(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    S seq = MakeSequence<S>(count);
+    PerfCountersScope perfCounters(state);
+    for (auto _ : state) {
+        Sequence<int>* result = seq.Slice(count / 4, count / 2);
+        benchmark::DoNotOptimize(result);
+        delete result;
+    }
+    SetThroughput(state, count);
+}
+
+template <typename S>
+void BM_FlatMap(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    S seq = MakeSequence<S>(count);
+    PerfCountersScope perfCounters(state);
+    for (auto _ : state) {
+        Sequence<int>* result = seq.FlatMap(doubleIntoSink);
+        benchmark::DoNotOptimize(result);
+        delete result;
+    }
+    SetThroughput(state, count);
+}
+
+template <typename S>
+void BM_Split(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    S seq = MakeSequence<S>(count);
+    PerfCountersScope perfCounters(state);
+    for (auto _ : state) {
+        auto parts = seq.Split(isEven);
+        benchmark::DoNotOptimize(parts.first);
+        delete parts.first;
+        delete parts.second;
+    }
+    SetThroughput(state, count);
+}
+
+template <typename S>
+void BM_Zip(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    S first = MakeSequence<S>(count);
+    S second = MakeSequence<S>(count);
+    PerfCountersScope perfCounters(state);
+    for (auto _ : state) {
+        auto* result = Zip(first, second);
+        benchmark::DoNotOptimize(result);
+        delete result;
+    }
+    SetThroughput(state, 2LL * count);
+}
+
+template <typename S>
+void BM_Unzip(benchmark::State& state) {
+    int count = static_cast<int>(state.range(0));
+    S first = MakeSequence<S>(count);
+    S second = MakeSequence<S>(count);
+    Sequence<std::pair<int, int>>* pairs = Zip(first, second);
+    PerfCountersScope perfCounters(state);
+    for (auto _ : state) {
+        auto parts = Unzip(*pairs);
+        benchmark::DoNotOptimize(parts.first);
+        delete parts.first;
+        delete parts.second;
+    }
+    delete pairs;
+    SetThroughput(state, 2LL * count);
+}
+
+}  // namespace
+
+#define REGISTER_FOR_ALL_SEQUENCES(benchmarkName, sizes)                      \
+    BENCHMARK_TEMPLATE(benchmarkName, ArraySequence<int>)->Apply(sizes);          \
+    BENCHMARK_TEMPLATE(benchmarkName, ListSequence<int>)->Apply(sizes);           \
+    BENCHMARK_TEMPLATE(benchmarkName, ImmutableArraySequence<int>)->Apply(sizes); \
+    BENCHMARK_TEMPLATE(benchmarkName, ImmutableListSequence<int>)->Apply(sizes)
+
+REGISTER_FOR_ALL_SEQUENCES(BM_Append, LinearSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_Prepend, QuadraticSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_InsertAt, LinearSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_Get, QuadraticSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_Enumerate, LinearSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_Map, LinearSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_Where, LinearSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_Reduce, LinearSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_Concat, LinearSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_Slice, LinearSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_FlatMap, LinearSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_Split, LinearSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_Zip, LinearSizes);
+REGISTER_FOR_ALL_SEQUENCES(BM_Unzip, LinearSizes);
+
+// Собственный флаг убирается из argv до разбора флагов Google Benchmark
+int main(int argc, char** argv) {
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--perf_counters") == 0) {
+            PerfCounters::Enabled() = true;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
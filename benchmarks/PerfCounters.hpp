@@ -0,0 +1,220 @@
+#pragma once
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Аппаратные счётчики через perf_event_open. Каждое событие открывается отдельно,
+// поэтому недоступное событие не мешает остальным; если не открылось ни одно
+// (нет прав, контейнер, не Linux), бенчмарки идут только с замером времени.
+// Считается только вызывающий поток — работа потоков ThreadPool не попадает в счётчики.
+class PerfCounters {
+public:
+    enum Event {
+        Cycles,
+        Instructions,
+        L1DataMisses,
+        LastLevelCacheMisses,
+        BranchMisses,
+        EventCount
+    };
+
+private:
+    int descriptors[EventCount];
+
+#ifdef __linux__
+    static int Open(std::uint32_t type, std::uint64_t config) {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = type;
+        attributes.config = config;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+
+    static std::uint64_t CacheConfig(std::uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+#endif
+
+public:
+    PerfCounters() {
+        for (int i = 0; i < EventCount; ++i) {
+            descriptors[i] = -1;
+        }
+#ifdef __linux__
+        descriptors[Cycles] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        descriptors[Instructions] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        descriptors[L1DataMisses] = Open(PERF_TYPE_HW_CACHE, CacheConfig(PERF_COUNT_HW_CACHE_L1D));
+        descriptors[LastLevelCacheMisses] = Open(PERF_TYPE_HW_CACHE, CacheConfig(PERF_COUNT_HW_CACHE_LL));
+        descriptors[BranchMisses] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int i = 0; i < EventCount; ++i) {
+            if (descriptors[i] >= 0) {
+                close(descriptors[i]);
+            }
+        }
+#endif
+    }
+
+    bool IsAvailable(Event event) const {
+        return descriptors[event] >= 0;
+    }
+
+    bool IsAnyAvailable() const {
+        for (int i = 0; i < EventCount; ++i) {
+            if (descriptors[i] >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Start() {
+#ifdef __linux__
+        for (int i = 0; i < EventCount; ++i) {
+            if (descriptors[i] >= 0) {
+                ioctl(descriptors[i], PERF_EVENT_IOC_RESET, 0);
+                ioctl(descriptors[i], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void Stop() {
+#ifdef __linux__
+        for (int i = 0; i < EventCount; ++i) {
+            if (descriptors[i] >= 0) {
+                ioctl(descriptors[i], PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+#endif
+    }
+
+    // Продолжает счёт после Stop() без сброса накопленного
+    void Resume() {
+#ifdef __linux__
+        for (int i = 0; i < EventCount; ++i) {
+            if (descriptors[i] >= 0) {
+                ioctl(descriptors[i], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    // Значение с поправкой на мультиплексирование; false, если событие недоступно
+    bool Read(Event event, double& value) const {
+#ifdef __linux__
+        if (descriptors[event] < 0) {
+            return false;
+        }
+        std::uint64_t data[3];  // значение, время включения, время работы
+        if (read(descriptors[event], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+            return false;
+        }
+        value = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        return true;
+#else
+        (void)event;
+        (void)value;
+        return false;
+#endif
+    }
+
+    static const char* GetName(Event event) {
+        switch (event) {
+            case Cycles: return "cycles";
+            case Instructions: return "instructions";
+            case L1DataMisses: return "L1D-misses";
+            case LastLevelCacheMisses: return "LLC-misses";
+            case BranchMisses: return "branch-misses";
+            default: return "unknown";
+        }
+    }
+
+    // Включается флагом --perf_counters в main бенчмарков
+    static bool& Enabled() {
+        static bool enabled = false;
+        return enabled;
+    }
+};
+
+// Считает события от создания до разрушения и добавляет их в state.counters
+// в пересчёте на итерацию. Без --perf_counters ничего не делает. Подготовку внутри
+// цикла исключают PauseTiming/ResumeTiming этого объекта: они останавливают и
+// таймер, и счётчики.
+class PerfCountersScope {
+private:
+    benchmark::State& state;
+    PerfCounters* counters;
+
+public:
+    explicit PerfCountersScope(benchmark::State& state) : state(state), counters(nullptr) {
+        if (!PerfCounters::Enabled()) {
+            return;
+        }
+        counters = new PerfCounters();
+        if (!counters->IsAnyAvailable()) {
+            static bool warned = false;
+            if (!warned) {
+                std::fprintf(stderr, "perf_event_open unavailable, reporting timing only\n");
+                warned = true;
+            }
+            delete counters;
+            counters = nullptr;
+            return;
+        }
+        counters->Start();
+    }
+
+    PerfCountersScope(const PerfCountersScope&) = delete;
+    PerfCountersScope& operator=(const PerfCountersScope&) = delete;
+
+    void PauseTiming() {
+        if (counters) {
+            counters->Stop();
+        }
+        state.PauseTiming();
+    }
+
+    void ResumeTiming() {
+        state.ResumeTiming();
+        if (counters) {
+            counters->Resume();
+        }
+    }
+
+    ~PerfCountersScope() {
+        if (!counters) {
+            return;
+        }
+        counters->Stop();
+        for (int i = 0; i < PerfCounters::EventCount; ++i) {
+            PerfCounters::Event event = static_cast<PerfCounters::Event>(i);
+            double value;
+            if (counters->Read(event, value)) {
+                state.counters[PerfCounters::GetName(event)] =
+                    benchmark::Counter(value, benchmark::Counter::kAvgIterations);
+            }
+        }
+        delete counters;
+    }
+};
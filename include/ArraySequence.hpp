@@ -1,20 +1,28 @@
 #pragma once
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <utility>
 #include "Sequence.hpp"
 #include "DynamicArray.hpp"
 #include "Exceptions.hpp"
+#include "ThreadPool.hpp"
+#include "BitSequence.hpp"
+#include "ParallelSort.hpp"
+#include "HashIndex.hpp"
 
 template <typename T>
 class ArraySequence : public Sequence<T> {
 protected:
     DynamicArray<T> array;
+    // Необязательный индекс значений; включается EnableHashIndex
+    ISequenceIndex<T>* valueIndex = nullptr;
 
 private:
     class ArraySequenceEnumerator : public IEnumerator<T> {
     private:
         const DynamicArray<T>& array;
         int currentIndex;
-        T currentValue;
 
     public:
         explicit ArraySequenceEnumerator(const DynamicArray<T>& array) 
@@ -23,17 +31,17 @@ private:
         bool MoveNext() override {
             if (currentIndex + 1 < array.GetSize()) {
                 currentIndex++;
-                currentValue = array.Get(currentIndex);
                 return true;
             }
             return false;
         }
 
+        // Ссылка прямо в хранилище, без копии элемента
         const T& Current() const override {
             if (currentIndex < 0 || currentIndex >= array.GetSize()) {
                 throw InvalidStateException("Enumerator is not in a valid position");
             }
-            return currentValue;
+            return array.GetData()[currentIndex];
         }
 
         void Reset() override {
@@ -41,20 +49,292 @@ private:
         }
     };
 
+protected:
+    // Имя класса в событиях трассировки. Наследники возвращают своё, чтобы и
+    // унаследованные операции (Reduce, Find, сортировки) подписывались их именем.
+    virtual const char* GetTraceName() const {
+        return "ArraySequence";
+    }
+
+    // Стабильное параллельное разбиение: подсчёт совпадений по чанкам, префиксная сумма
+    // смещений и раскладка в два буфера точного размера. Предикат вызывается дважды
+    // для каждого элемента, поэтому он должен быть чистой функцией.
+    void PartitionInto(bool (*predicate)(const T&), DynamicArray<T>& matching, DynamicArray<T>& notMatching) const {
+        int length = array.GetSize();
+        int chunkCount = ParallelChunkCount(length);
+        const T* source = array.GetData();
+
+        DynamicArray<int> matchOffsets(chunkCount);
+        int* offsets = matchOffsets.GetData();
+        ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+            int begin, end;
+            GetChunkRange(length, chunkCount, chunk, begin, end);
+            int count = 0;
+            for (int i = begin; i < end; ++i) {
+                if (predicate(source[i])) {
+                    ++count;
+                }
+            }
+            offsets[chunk] = count;
+        });
+
+        int total = 0;
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            int count = offsets[chunk];
+            offsets[chunk] = total;
+            total += count;
+        }
+
+        matching = DynamicArray<T>(total);
+        notMatching = DynamicArray<T>(length - total);
+        T* matchingItems = matching.GetData();
+        T* notMatchingItems = notMatching.GetData();
+        ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+            int begin, end;
+            GetChunkRange(length, chunkCount, chunk, begin, end);
+            int matchPos = offsets[chunk];
+            int notMatchPos = begin - offsets[chunk];
+            for (int i = begin; i < end; ++i) {
+                if (predicate(source[i])) {
+                    matchingItems[matchPos++] = source[i];
+                } else {
+                    notMatchingItems[notMatchPos++] = source[i];
+                }
+            }
+        });
+    }
+
+    void NotifyInserted(const T& item, int index) {
+        if (valueIndex != nullptr) {
+            valueIndex->OnInsert(item, index, array.GetSize());
+        }
+    }
+
+    // После перестановки элементов позиции в индексе устаревают целиком
+    void RebuildIndex() {
+        if (valueIndex != nullptr) {
+            valueIndex->Rebuild(array.GetData(), array.GetSize());
+        }
+    }
+
+    // Новая последовательность получает индекс того же вида, что и source
+    void InheritIndex(const ArraySequence<T>& source) {
+        if (source.valueIndex != nullptr) {
+            delete valueIndex;
+            valueIndex = source.valueIndex->CreateEmpty();
+            RebuildIndex();
+        }
+    }
+
+    // Сортировки меняют массив на месте; неизменяемые наследники это запрещают
+    virtual void CheckMutable() const {}
+
+    template <typename Compare>
+    void SortInPlace(Compare compare, bool stable) {
+        CheckMutable();
+        ParallelMergeSort(array.GetData(), array.GetSize(), compare, stable);
+        RebuildIndex();
+    }
+
+    // Для целых и float/double — поразрядная сортировка; на малых массивах она
+    // не окупается
+    void SortNatural(bool stable) {
+        CheckMutable();
+        bool sorted = false;
+        if constexpr (RadixTraits<T>::Supported) {
+            if (array.GetSize() >= RadixSortThreshold) {
+                RadixSort(array.GetData(), array.GetSize());
+                sorted = true;
+            }
+        }
+        if (!sorted) {
+            ParallelMergeSort(array.GetData(), array.GetSize(), std::less<T>(), stable);
+        }
+        RebuildIndex();
+    }
+
+    // Ёмкость растёт геометрически, поэтому серия Append амортизированно линейна
+    void ReserveForOneMore() {
+        int size = array.GetSize();
+        if (size == array.GetCapacity()) {
+            array.Reserve(size < 8 ? 8 : size * 2);
+        }
+    }
+
+    static void AppendAll(const Sequence<T>* source, DynamicArraySink<T>& sink) {
+        IEnumerator<T>* enumerator = source->GetEnumerator();
+        while (enumerator->MoveNext()) {
+            sink.Push(enumerator->Current());
+        }
+        delete enumerator;
+    }
+
+    void MapInto(T (*func)(const T&), DynamicArray<T>& result) const {
+        int length = array.GetSize();
+        const T* source = array.GetData();
+        result = DynamicArray<T>(length);
+        T* items = result.GetData();
+        for (int i = 0; i < length; ++i) {
+            items[i] = func(source[i]);
+        }
+    }
+
+    void WhereInto(bool (*predicate)(const T&), DynamicArray<T>& result) const {
+        const T* source = array.GetData();
+        DynamicArraySink<T> sink(result);
+        for (int i = 0; i < array.GetSize(); ++i) {
+            if (predicate(source[i])) {
+                sink.Push(source[i]);
+            }
+        }
+    }
+
+    // Выбор по маске: результат выделяется сразу нужного размера, единичные биты
+    // перебираются через ctz, нулевые слова пропускаются целиком
+    void WhereInto(const BitSequence& mask, DynamicArray<T>& result) const {
+        if (mask.GetLength() != array.GetSize()) {
+            throw InvalidSizeException("Mask length must match sequence length");
+        }
+        const T* source = array.GetData();
+        const std::uint64_t* words = mask.GetWords();
+        result = DynamicArray<T>(mask.CountOnes());
+        T* items = result.GetData();
+        int written = 0;
+        for (int word = 0; word < mask.GetWordCount(); ++word) {
+            int base = word * 64;
+            for (std::uint64_t bits = words[word]; bits != 0; bits &= bits - 1) {
+                items[written++] = source[base + BitSequence::TrailingZeros(bits)];
+            }
+        }
+    }
+
+    // Slice: удаляет N элементов начиная с позиции i и вставляет элементы из последовательности s
+    void SliceInto(int i, int N, const Sequence<T>* s, DynamicArray<T>& result) const {
+        int length = array.GetSize();
+
+        if (i < 0) {
+            i = length + i;
+        }
+        if (i < 0 || i >= length) {
+            throw IndexOutOfRangeException("Invalid slice index");
+        }
+        if (i + N > length) {
+            N = length - i;
+        }
+
+        const T* source = array.GetData();
+        int insertedLength = s != nullptr ? s->GetLength() : 0;
+        result.Reserve(length - N + insertedLength);
+        DynamicArraySink<T> sink(result);
+        for (int j = 0; j < i; ++j) {
+            sink.Push(source[j]);
+        }
+        if (s != nullptr) {
+            AppendAll(s, sink);
+        }
+        for (int j = i + N; j < length; ++j) {
+            sink.Push(source[j]);
+        }
+    }
+
+    void ConcatInto(const Sequence<T>* other, DynamicArray<T>& result) const {
+        int length = array.GetSize();
+        const T* source = array.GetData();
+        result.Reserve(length + other->GetLength());
+        DynamicArraySink<T> sink(result);
+        for (int i = 0; i < length; ++i) {
+            sink.Push(source[i]);
+        }
+        AppendAll(other, sink);
+    }
+
+    void FlatMapInto(Sequence<T>* (*func)(const T&), DynamicArray<T>& result) const {
+        const T* source = array.GetData();
+        DynamicArraySink<T> sink(result);
+        for (int i = 0; i < array.GetSize(); ++i) {
+            Sequence<T>* subseq = func(source[i]);
+            AppendAll(subseq, sink);
+            delete subseq;
+        }
+    }
+
+    void FlatMapInto(void (*func)(const T&, ISequenceSink<T>&), DynamicArray<T>& result) const {
+        result.Reserve(array.GetSize());
+        DynamicArraySink<T> sink(result);
+        const T* source = array.GetData();
+        for (int i = 0; i < array.GetSize(); ++i) {
+            func(source[i], sink);
+        }
+    }
+
+    // Параллельный FlatMap: размеры выхода по чанкам, префиксная сумма смещений,
+    // заполнение общего буфера. Функция вызывается дважды на элемент и должна
+    // выдавать одно и то же количество элементов.
+    void ParallelFlatMapInto(void (*func)(const T&, ISequenceSink<T>&), DynamicArray<T>& result) const {
+        int length = array.GetSize();
+        int chunkCount = ParallelChunkCount(length);
+        const T* source = array.GetData();
+
+        DynamicArray<long long> chunkOffsets(chunkCount);
+        long long* offsets = chunkOffsets.GetData();
+        ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+            int begin, end;
+            GetChunkRange(length, chunkCount, chunk, begin, end);
+            CountingSink<T> counter;
+            for (int i = begin; i < end; ++i) {
+                func(source[i], counter);
+            }
+            offsets[chunk] = counter.GetCount();
+        });
+
+        long long total = 0;
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            long long count = offsets[chunk];
+            offsets[chunk] = total;
+            total += count;
+        }
+        if (total > std::numeric_limits<int>::max()) {
+            throw InvalidSizeException("FlatMap result is too large");
+        }
+
+        result = DynamicArray<T>(static_cast<int>(total));
+        T* items = result.GetData();
+        ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+            int begin, end;
+            GetChunkRange(length, chunkCount, chunk, begin, end);
+            long long chunkEnd = chunk + 1 < chunkCount ? offsets[chunk + 1] : total;
+            BufferSink<T> sink(items + offsets[chunk], static_cast<int>(chunkEnd - offsets[chunk]));
+            for (int i = begin; i < end; ++i) {
+                func(source[i], sink);
+            }
+            if (sink.GetWritten() != chunkEnd - offsets[chunk]) {
+                throw InvalidStateException("Sink underfilled: function produced a different number of elements");
+            }
+        });
+    }
+
 public:
     ArraySequence() = default;
     ArraySequence(T* items, int count) : array(items, count) {}
-    ArraySequence(const T* items, int count) {
-        T* nonConstItems = new T[count];
-        for (int i = 0; i < count; ++i) {
-            nonConstItems[i] = items[i];
-        }
-        array = DynamicArray<T>(nonConstItems, count);
-        delete[] nonConstItems;
-    }
+    ArraySequence(const T* items, int count) : array(items, count) {}
     ArraySequence(const DynamicArray<T>& other) : array(other) {}
+    ArraySequence(DynamicArray<T>&& other) : array(std::move(other)) {}
     // from
-    ArraySequence(const ArraySequence<T>& other) : array(other.array) {}
+    ArraySequence(const ArraySequence<T>& other)
+        : array(other.array), valueIndex(other.valueIndex != nullptr ? other.valueIndex->Clone() : nullptr) {}
+
+    ArraySequence<T>& operator=(const ArraySequence<T>& other) {
+        if (this != &other) {
+            array = other.array;
+            delete valueIndex;
+            valueIndex = other.valueIndex != nullptr ? other.valueIndex->Clone() : nullptr;
+        }
+        return *this;
+    }
+
+    ~ArraySequence() override {
+        delete valueIndex;
+    }
 
     T Get(int index) const override {
         return array.Get(index);
@@ -100,157 +380,312 @@ public:
             throw IndexOutOfRangeException("Invalid subsequence indices");
         }
         int length = endIndex - startIndex + 1;
-        T* items = new T[length];
-        for (int i = 0; i < length; ++i) {
-            items[i] = array.Get(startIndex + i);
-        }
-        ArraySequence<T>* result = new ArraySequence<T>(items, length);
-        delete[] items;
-        return result;
+        return new ArraySequence<T>(DynamicArray<T>(array.GetData() + startIndex, length));
     }
 
     int GetLength() const override {
         return array.GetSize();
     }
 
+    MemoryUsage MemoryFootprint() const override {
+        MemoryUsage usage;
+        usage.payloadBytes = static_cast<long long>(sizeof(T)) * array.GetSize();
+        usage.slackBytes = static_cast<long long>(sizeof(T)) * (array.GetCapacity() - array.GetSize());
+        if (valueIndex != nullptr) {
+            usage.overheadBytes = valueIndex->GetMemoryBytes();
+        }
+        return usage;
+    }
+
+    // Непрерывное хранилище только для чтения — для массовых операций
+    const T* GetData() const {
+        return array.GetData();
+    }
+
     void Append(const T& item) override {
+        ReserveForOneMore();
         int oldSize = array.GetSize();
         array.Resize(oldSize + 1);
         array.Set(oldSize, item);
+        NotifyInserted(item, oldSize);
     }
 
     void Prepend(const T& item) override {
-        int oldSize = array.GetSize();
-        array.Resize(oldSize + 1);
-        for (int i = oldSize; i > 0; --i) {
-            array.Set(i, array.Get(i - 1));
-        }
-        array.Set(0, item);
+        InsertAt(item, 0);
     }
 
     void InsertAt(const T& item, int index) override {
         if (index < 0 || index > array.GetSize()) {
             throw IndexOutOfRangeException("Invalid insert index");
         }
+        ReserveForOneMore();
         int oldSize = array.GetSize();
         array.Resize(oldSize + 1);
+        T* items = array.GetData();
         for (int i = oldSize; i > index; --i) {
-            array.Set(i, array.Get(i - 1));
+            items[i] = std::move(items[i - 1]);
         }
-        array.Set(index, item);
+        items[index] = item;
+        NotifyInserted(item, index);
     }
 
-    Sequence<T>* Map(T (*func)(const T&)) const override {
-        ArraySequence<T>* result = new ArraySequence<T>();
+    // Индекс значений для IndexOf, Contains и FindValue за O(1) в среднем.
+    // Поддерживается при Append/Prepend/InsertAt и сортировках; Slice выдаёт
+    // последовательность с таким же индексом
+    template <typename Hash = std::hash<T>>
+    void EnableHashIndex(Hash hash = Hash()) {
+        delete valueIndex;
+        valueIndex = new HashIndex<T, Hash>(hash);
+        RebuildIndex();
+    }
+
+    void DisableHashIndex() {
+        delete valueIndex;
+        valueIndex = nullptr;
+    }
+
+    bool HasHashIndex() const {
+        return valueIndex != nullptr;
+    }
+
+    // Первая позиция значения или -1; без индекса — линейный поиск
+    int IndexOf(const T& item) const {
+        if (valueIndex != nullptr) {
+            return valueIndex->IndexOf(item);
+        }
+        const T* items = array.GetData();
         for (int i = 0; i < array.GetSize(); ++i) {
-            result->Append(func(array.Get(i)));
+            if (items[i] == item) {
+                return i;
+            }
         }
-        return result;
+        return -1;
     }
 
-    Sequence<T>* Where(bool (*predicate)(const T&)) const override {
-        ArraySequence<T>* result = new ArraySequence<T>();
+    bool Contains(const T& item) const {
+        return IndexOf(item) >= 0;
+    }
+
+    int CountOf(const T& item) const {
+        if (valueIndex != nullptr) {
+            return valueIndex->CountOf(item);
+        }
+        int count = 0;
+        const T* items = array.GetData();
         for (int i = 0; i < array.GetSize(); ++i) {
-            T current = array.Get(i);
-            if (predicate(current)) {
-                result->Append(current);
+            if (items[i] == item) {
+                ++count;
             }
         }
-        return result;
+        return count;
     }
 
-    T Reduce(T (*func)(const T&, const T&), const T& initial) const override {
-        T result = initial;
-        for (int i = 0; i < array.GetSize(); ++i) {
-            result = func(result, array.Get(i));
+    // Отдельное имя, а не перегрузка Find: для Find(0) литерал одинаково хорошо
+    // приводится и к T, и к указателю на предикат
+    Option<T> FindValue(const T& value) const {
+        int index = IndexOf(value);
+        if (index < 0) {
+            return Option<T>::None();
         }
-        return result;
+        return Option<T>::Some(array.GetData()[index]);
+    }
+
+    // Сортировка на месте по возрастанию (std::less)
+    void Sort() {
+        SEQUENCE_TRACE_SCOPE("Sort", GetTraceName());
+        SortNatural(false);
     }
 
-    Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const override { // Slice: удаляет N элементов начиная с позиции i и вставляет элементы из последовательности s
+    template <typename Compare>
+    void Sort(Compare compare) {
+        SEQUENCE_TRACE_SCOPE("Sort", GetTraceName());
+        SortInPlace(compare, false);
+    }
+
+    // Равные элементы сохраняют исходный порядок
+    void StableSort() {
+        SEQUENCE_TRACE_SCOPE("StableSort", GetTraceName());
+        SortNatural(true);
+    }
+
+    template <typename Compare>
+    void StableSort(Compare compare) {
+        SEQUENCE_TRACE_SCOPE("StableSort", GetTraceName());
+        SortInPlace(compare, true);
+    }
+
+    // Стабильная сортировка по ключу: ключи вычисляются один раз, сортируется
+    // перестановка индексов, затем элементы переставляются за один проход
+    template <typename Key>
+    void SortBy(Key (*key)(const T&)) {
+        SEQUENCE_TRACE_SCOPE("SortBy", GetTraceName());
+        CheckMutable();
         int length = array.GetSize();
-    
-        if (i < 0) {
-            i = length + i;
-        }
-        if (i < 0 || i >= length) {
-            throw IndexOutOfRangeException("Invalid slice index");
-        }
-        if (i + N > length) {
-            N = length - i;
+        T* items = array.GetData();
+        DynamicArray<Key> keys(length);
+        DynamicArray<int> order(length);
+        Key* keyData = keys.GetData();
+        int* orderData = order.GetData();
+        int chunkCount = ParallelChunkCount(length);
+        ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+            int begin, end;
+            GetChunkRange(length, chunkCount, chunk, begin, end);
+            for (int i = begin; i < end; ++i) {
+                keyData[i] = key(items[i]);
+                orderData[i] = i;
+            }
+        });
+
+        bool sorted = false;
+        if constexpr (RadixTraits<Key>::Supported) {
+            if (length >= RadixSortThreshold) {
+                RadixSortWithPayload(keyData, orderData, length);
+                sorted = true;
+            }
         }
-        
-        ArraySequence<T>* result = new ArraySequence<T>();
-        
-        for (int j = 0; j < i; ++j) {
-            result->Append(array.Get(j));
+        if (!sorted) {
+            ParallelMergeSort(orderData, length, [keyData](int a, int b) { return keyData[a] < keyData[b]; }, true);
         }
-        
-        if (s != nullptr) {
-            for (int j = 0; j < s->GetLength(); ++j) {
-                result->Append(s->Get(j));
+
+        DynamicArray<T> result(length);
+        T* target = result.GetData();
+        ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+            int begin, end;
+            GetChunkRange(length, chunkCount, chunk, begin, end);
+            for (int i = begin; i < end; ++i) {
+                target[i] = std::move(items[orderData[i]]);
             }
+        });
+        array = std::move(result);
+        RebuildIndex();
+    }
+
+    // Ставит на позицию n элемент, который стоял бы там после сортировки: левее не
+    // большие, правее не меньшие. Интроселект, O(n) в среднем и O(n log n) в худшем
+    T NthElement(int n) {
+        return NthElement(n, std::less<T>());
+    }
+
+    template <typename Compare>
+    T NthElement(int n, Compare compare) {
+        SEQUENCE_TRACE_SCOPE("NthElement", GetTraceName());
+        CheckMutable();
+        if (n < 0 || n >= array.GetSize()) {
+            throw IndexOutOfRangeException("Index out of range");
         }
+        T* items = array.GetData();
+        std::nth_element(items, items + n, items + array.GetSize(), compare);
+        RebuildIndex();
+        return items[n];
+    }
 
-        for (int j = i + N; j < length; ++j) {
-            result->Append(array.Get(j));
+    // Нижняя медиана; элементы переставляются, как в NthElement
+    T Median() {
+        if (array.GetSize() == 0) {
+            throw EmptySequenceException();
         }
-        
-        return result;
+        return NthElement((array.GetSize() - 1) / 2);
     }
 
-    Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const override {
-        ArraySequence<T>* result = new ArraySequence<T>();
+    Sequence<T>* Map(T (*func)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("Map", GetTraceName());
+        DynamicArray<T> result;
+        MapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    Sequence<T>* Where(bool (*predicate)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("Where", GetTraceName());
+        DynamicArray<T> result;
+        WhereInto(predicate, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    Sequence<T>* Where(const BitSequence& mask) const {
+        SEQUENCE_TRACE_SCOPE("WhereMask", GetTraceName());
+        DynamicArray<T> result;
+        WhereInto(mask, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    T Reduce(T (*func)(const T&, const T&), const T& initial) const override {
+        SEQUENCE_TRACE_SCOPE("Reduce", GetTraceName());
+        T result = initial;
+        const T* source = array.GetData();
         for (int i = 0; i < array.GetSize(); ++i) {
-            Sequence<T>* subseq = func(array.Get(i));
-            for (int j = 0; j < subseq->GetLength(); ++j) {
-                result->Append(subseq->Get(j));
-            }
-            delete subseq;
+            result = func(result, source[i]);
         }
         return result;
     }
 
+    Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const override {
+        SEQUENCE_TRACE_SCOPE("Slice", GetTraceName());
+        DynamicArray<T> result;
+        SliceInto(i, N, s, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        ArraySequence<T>* sliced = new ArraySequence<T>(std::move(result));
+        sliced->InheritIndex(*this);
+        return sliced;
+    }
+
+    Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("FlatMap", GetTraceName());
+        DynamicArray<T> result;
+        FlatMapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    Sequence<T>* FlatMap(void (*func)(const T&, ISequenceSink<T>&)) const override {
+        SEQUENCE_TRACE_SCOPE("FlatMap", GetTraceName());
+        DynamicArray<T> result;
+        FlatMapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    Sequence<T>* ParallelFlatMap(void (*func)(const T&, ISequenceSink<T>&)) const {
+        SEQUENCE_TRACE_SCOPE("ParallelFlatMap", GetTraceName());
+        DynamicArray<T> result;
+        ParallelFlatMapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ArraySequence<T>(std::move(result));
+    }
+
     Option<T> Find(bool (*predicate)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("Find", GetTraceName());
+        const T* source = array.GetData();
         for (int i = 0; i < array.GetSize(); ++i) {
-            if (predicate(array.Get(i))) {
-                return Option<T>::Some(array.Get(i));
+            if (predicate(source[i])) {
+                return Option<T>::Some(source[i]);
             }
         }
         return Option<T>::None();
     }
 
     std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const override {
-        ArraySequence<T>* matching = new ArraySequence<T>();
-        ArraySequence<T>* notMatching = new ArraySequence<T>();
-
-        for (int i = 0; i < array.GetSize(); ++i) {
-            T current = array.Get(i);
-            if (predicate(current)) {
-                matching->Append(current);
-            } else {
-                notMatching->Append(current);
-            }
-        }
-
-        return std::make_pair(matching, notMatching);
+        SEQUENCE_TRACE_SCOPE("Split", GetTraceName());
+        DynamicArray<T> matching;
+        DynamicArray<T> notMatching;
+        PartitionInto(predicate, matching, notMatching);
+        SEQUENCE_TRACE_OUTPUT(matching.GetSize() + notMatching.GetSize());
+        return std::make_pair(new ArraySequence<T>(std::move(matching)),
+                              new ArraySequence<T>(std::move(notMatching)));
     }
 
     Sequence<T>* Concat(const Sequence<T>* other) const override {
-        ArraySequence<T>* result = new ArraySequence<T>();
-        
-        for (int i = 0; i < array.GetSize(); ++i) {
-            result->Append(array.Get(i));
-        }
-        
-        for (int i = 0; i < other->GetLength(); ++i) {
-            result->Append(other->Get(i));
-        }
-        
-        return result;
+        SEQUENCE_TRACE_SCOPE("Concat", GetTraceName());
+        DynamicArray<T> result;
+        ConcatInto(other, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ArraySequence<T>(std::move(result));
     }
 
     IEnumerator<T>* GetEnumerator() const override {
+        SEQUENCE_COUNT(EnumeratorAllocations, 1);
         return new ArraySequenceEnumerator(array);
     }
 };
\ No newline at end of file
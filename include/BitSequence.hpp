@@ -0,0 +1,556 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include "Sequence.hpp"
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+
+// Последовательность bool, упакованная по 64 бита в слово. Биты за концом
+// последовательности в последнем слове всегда нулевые — на этом держатся
+// подсчёт через popcount и поиск через ctz без дополнительных масок.
+// Map и Where для bool сводятся к четырём случаям (тождество, отрицание,
+// константы) и выполняются целыми словами.
+class BitSequence : public Sequence<bool> {
+private:
+    static constexpr int WordBits = 64;
+
+    class BitSequenceEnumerator : public IEnumerator<bool> {
+    private:
+        const BitSequence& sequence;
+        int currentIndex;
+        bool currentValue;
+
+    public:
+        explicit BitSequenceEnumerator(const BitSequence& sequence)
+            : sequence(sequence), currentIndex(-1), currentValue(false) {}
+
+        bool MoveNext() override {
+            if (currentIndex + 1 < sequence.length) {
+                currentIndex++;
+                currentValue = sequence.GetBit(currentIndex);
+                return true;
+            }
+            return false;
+        }
+
+        const bool& Current() const override {
+            if (currentIndex < 0 || currentIndex >= sequence.length) {
+                throw InvalidStateException("Enumerator is not in a valid position");
+            }
+            return currentValue;
+        }
+
+        void Reset() override {
+            currentIndex = -1;
+        }
+    };
+
+    class BitSink : public ISequenceSink<bool> {
+    private:
+        BitSequence& target;
+
+    public:
+        explicit BitSink(BitSequence& target) : target(target) {}
+
+        void Push(const bool& item) override {
+            target.Append(item);
+        }
+    };
+
+    DynamicArray<std::uint64_t> words;
+    int length;
+
+    static int WordCount(int bits) {
+        return (bits + WordBits - 1) / WordBits;
+    }
+
+    // Маска младших count бит, count в [0, 64]
+    static std::uint64_t LowMask(int count) {
+        return count >= WordBits ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+    }
+
+    bool GetBit(int index) const {
+        return (words.GetData()[index / WordBits] >> (index % WordBits)) & 1;
+    }
+
+    void EnsureWords(int count) {
+        int size = words.GetSize();
+        if (count <= size) {
+            return;
+        }
+        if (count > words.GetCapacity()) {
+            int doubled = words.GetCapacity() * 2;
+            words.Reserve(count > doubled ? count : doubled);
+        }
+        words.Resize(count);
+    }
+
+    // Обнуляет биты за концом последовательности в последнем слове
+    void ClearTail() {
+        int tail = length % WordBits;
+        if (tail != 0) {
+            words.GetData()[length / WordBits] &= LowMask(tail);
+        }
+    }
+
+    // 64 бита начиная с позиции begin; за концом слов — нули
+    std::uint64_t ExtractWord(int begin) const {
+        const std::uint64_t* data = words.GetData();
+        int word = begin / WordBits;
+        int offset = begin % WordBits;
+        std::uint64_t result = data[word] >> offset;
+        if (offset != 0 && word + 1 < words.GetSize()) {
+            result |= data[word + 1] << (WordBits - offset);
+        }
+        return result;
+    }
+
+    // Дописывает count младших бит из bits
+    void AppendBits(std::uint64_t bits, int count) {
+        if (count == 0) {
+            return;
+        }
+        bits &= LowMask(count);
+        EnsureWords(WordCount(length + count));
+        std::uint64_t* data = words.GetData();
+        int word = length / WordBits;
+        int offset = length % WordBits;
+        data[word] |= bits << offset;
+        if (offset != 0 && offset + count > WordBits) {
+            data[word + 1] |= bits >> (WordBits - offset);
+        }
+        length += count;
+    }
+
+    void AppendRange(const BitSequence& source, int begin, int end) {
+        EnsureWords(WordCount(length + (end - begin)));
+        for (int position = begin; position < end; position += WordBits) {
+            int count = end - position < WordBits ? end - position : WordBits;
+            AppendBits(source.ExtractWord(position), count);
+        }
+    }
+
+    void AppendRepeated(bool value, int count) {
+        std::uint64_t bits = value ? ~std::uint64_t(0) : 0;
+        for (; count > 0; count -= WordBits) {
+            AppendBits(bits, count < WordBits ? count : WordBits);
+        }
+    }
+
+    void AppendAll(const Sequence<bool>* source) {
+        const BitSequence* bits = dynamic_cast<const BitSequence*>(source);
+        if (bits != nullptr) {
+            AppendRange(*bits, 0, bits->length);
+            return;
+        }
+        IEnumerator<bool>* enumerator = source->GetEnumerator();
+        while (enumerator->MoveNext()) {
+            Append(enumerator->Current());
+        }
+        delete enumerator;
+    }
+
+    void CheckSameLength(const BitSequence& other) const {
+        if (other.length != length) {
+            throw InvalidSizeException("Bit sequences must have the same length");
+        }
+    }
+
+    int FindNext(int from, bool value) const {
+        if (from < 0) {
+            from = 0;
+        }
+        if (from >= length) {
+            return -1;
+        }
+        const std::uint64_t* data = words.GetData();
+        int word = from / WordBits;
+        int wordCount = words.GetSize();
+        std::uint64_t current = value ? data[word] : ~data[word];
+        current &= ~LowMask(from % WordBits);
+        while (true) {
+            if (current != 0) {
+                int index = word * WordBits + TrailingZeros(current);
+                return index < length ? index : -1;
+            }
+            if (++word >= wordCount) {
+                return -1;
+            }
+            current = value ? data[word] : ~data[word];
+        }
+    }
+
+public:
+    static int PopCount(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(word);
+#else
+        int count = 0;
+        for (; word != 0; word &= word - 1) {
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    // Номер младшего единичного бита; для нуля не определён
+    static int TrailingZeros(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(word);
+#else
+        int count = 0;
+        for (; (word & 1) == 0; word >>= 1) {
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    BitSequence() : length(0) {}
+
+    BitSequence(int count, bool value) : length(0) {
+        if (count < 0) {
+            throw InvalidSizeException("Bit sequence length cannot be negative");
+        }
+        AppendRepeated(value, count);
+    }
+
+    BitSequence(const bool* items, int count) : length(0) {
+        if (count < 0) {
+            throw InvalidSizeException("Bit sequence length cannot be negative");
+        }
+        EnsureWords(WordCount(count));
+        std::uint64_t* data = words.GetData();
+        for (int i = 0; i < count; ++i) {
+            data[i / WordBits] |= std::uint64_t(items[i]) << (i % WordBits);
+        }
+        length = count;
+    }
+
+    BitSequence(const BitSequence& other) : words(other.words), length(other.length) {}
+
+    // Маска по предикату: бит i равен predicate(source[i]); слово собирается
+    // в регистре и записывается целиком
+    template <typename T>
+    static BitSequence* FromPredicate(const Sequence<T>& source, bool (*predicate)(const T&)) {
+        BitSequence* result = new BitSequence();
+        result->EnsureWords(WordCount(source.GetLength()));
+        IEnumerator<T>* enumerator = source.GetEnumerator();
+        std::uint64_t word = 0;
+        int filled = 0;
+        while (enumerator->MoveNext()) {
+            word |= std::uint64_t(predicate(enumerator->Current())) << filled;
+            if (++filled == WordBits) {
+                result->AppendBits(word, WordBits);
+                word = 0;
+                filled = 0;
+            }
+        }
+        delete enumerator;
+        result->AppendBits(word, filled);
+        return result;
+    }
+
+    bool Get(int index) const override {
+        if (index < 0 || index >= length) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        return GetBit(index);
+    }
+
+    void Set(int index, bool value) {
+        if (index < 0 || index >= length) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        std::uint64_t bit = std::uint64_t(1) << (index % WordBits);
+        if (value) {
+            words[index / WordBits] |= bit;
+        } else {
+            words[index / WordBits] &= ~bit;
+        }
+    }
+
+    bool GetFirst() const override {
+        if (length == 0) {
+            throw EmptySequenceException();
+        }
+        return GetBit(0);
+    }
+
+    bool GetLast() const override {
+        if (length == 0) {
+            throw EmptySequenceException();
+        }
+        return GetBit(length - 1);
+    }
+
+    Option<bool> TryGet(int index) const override {
+        if (index < 0 || index >= length) {
+            return Option<bool>::None();
+        }
+        return Option<bool>::Some(GetBit(index));
+    }
+
+    Option<bool> TryGetFirst() const override {
+        if (length == 0) {
+            return Option<bool>::None();
+        }
+        return Option<bool>::Some(GetBit(0));
+    }
+
+    Option<bool> TryGetLast() const override {
+        if (length == 0) {
+            return Option<bool>::None();
+        }
+        return Option<bool>::Some(GetBit(length - 1));
+    }
+
+    int GetLength() const override {
+        return length;
+    }
+
+    // Слова хранения: бит i лежит в слове i / 64 на позиции i % 64
+    const std::uint64_t* GetWords() const {
+        return words.GetData();
+    }
+
+    int GetWordCount() const {
+        return words.GetSize();
+    }
+
+    int CountOnes() const {
+        const std::uint64_t* data = words.GetData();
+        int count = 0;
+        for (int i = 0; i < words.GetSize(); ++i) {
+            count += PopCount(data[i]);
+        }
+        return count;
+    }
+
+    int CountZeros() const {
+        return length - CountOnes();
+    }
+
+    // Индекс первого бита со значением true (false) не раньше from, или -1
+    int FindNextSet(int from = 0) const {
+        return FindNext(from, true);
+    }
+
+    int FindNextClear(int from = 0) const {
+        return FindNext(from, false);
+    }
+
+    BitSequence* And(const BitSequence& other) const {
+        CheckSameLength(other);
+        BitSequence* result = new BitSequence(*this);
+        std::uint64_t* target = result->words.GetData();
+        const std::uint64_t* source = other.words.GetData();
+        for (int i = 0; i < words.GetSize(); ++i) {
+            target[i] &= source[i];
+        }
+        return result;
+    }
+
+    BitSequence* Or(const BitSequence& other) const {
+        CheckSameLength(other);
+        BitSequence* result = new BitSequence(*this);
+        std::uint64_t* target = result->words.GetData();
+        const std::uint64_t* source = other.words.GetData();
+        for (int i = 0; i < words.GetSize(); ++i) {
+            target[i] |= source[i];
+        }
+        return result;
+    }
+
+    BitSequence* Xor(const BitSequence& other) const {
+        CheckSameLength(other);
+        BitSequence* result = new BitSequence(*this);
+        std::uint64_t* target = result->words.GetData();
+        const std::uint64_t* source = other.words.GetData();
+        for (int i = 0; i < words.GetSize(); ++i) {
+            target[i] ^= source[i];
+        }
+        return result;
+    }
+
+    BitSequence* Not() const {
+        BitSequence* result = new BitSequence(*this);
+        std::uint64_t* target = result->words.GetData();
+        for (int i = 0; i < words.GetSize(); ++i) {
+            target[i] = ~target[i];
+        }
+        result->ClearTail();
+        return result;
+    }
+
+    Sequence<bool>* GetSubsequence(int startIndex, int endIndex) const override {
+        if (startIndex < 0 || endIndex >= length || startIndex > endIndex) {
+            throw IndexOutOfRangeException("Invalid subsequence indices");
+        }
+        BitSequence* result = new BitSequence();
+        result->AppendRange(*this, startIndex, endIndex + 1);
+        return result;
+    }
+
+    void Append(const bool& item) override {
+        if (length % WordBits == 0) {
+            EnsureWords(WordCount(length + 1));
+        }
+        if (item) {
+            words.GetData()[length / WordBits] |= std::uint64_t(1) << (length % WordBits);
+        }
+        length++;
+    }
+
+    void Prepend(const bool& item) override {
+        InsertAt(item, 0);
+    }
+
+    // Сдвигает хвост начиная с index на один бит вверх целыми словами
+    void InsertAt(const bool& item, int index) override {
+        if (index < 0 || index > length) {
+            throw IndexOutOfRangeException("Invalid insert index");
+        }
+        EnsureWords(WordCount(length + 1));
+        std::uint64_t* data = words.GetData();
+        int first = index / WordBits;
+        for (int word = WordCount(length + 1) - 1; word > first; --word) {
+            data[word] = (data[word] << 1) | (data[word - 1] >> (WordBits - 1));
+        }
+        std::uint64_t low = LowMask(index % WordBits);
+        data[first] = (data[first] & low) | ((data[first] & ~low) << 1);
+        if (item) {
+            data[first] |= std::uint64_t(1) << (index % WordBits);
+        }
+        length++;
+    }
+
+    Sequence<bool>* Map(bool (*func)(const bool&)) const override {
+        SEQUENCE_TRACE_SCOPE("Map", "BitSequence");
+        bool onFalse = func(false);
+        bool onTrue = func(true);
+        BitSequence* result;
+        if (onFalse == onTrue) {
+            result = new BitSequence(length, onTrue);
+        } else if (onTrue) {
+            result = new BitSequence(*this);
+        } else {
+            result = Not();
+        }
+        SEQUENCE_TRACE_OUTPUT(length);
+        return result;
+    }
+
+    // Результат Where состоит из одинаковых значений — нужно лишь их число
+    Sequence<bool>* Where(bool (*predicate)(const bool&)) const override {
+        SEQUENCE_TRACE_SCOPE("Where", "BitSequence");
+        bool keepFalse = predicate(false);
+        bool keepTrue = predicate(true);
+        BitSequence* result;
+        if (keepFalse && keepTrue) {
+            result = new BitSequence(*this);
+        } else if (keepTrue) {
+            result = new BitSequence(CountOnes(), true);
+        } else if (keepFalse) {
+            result = new BitSequence(CountZeros(), false);
+        } else {
+            result = new BitSequence();
+        }
+        SEQUENCE_TRACE_OUTPUT(result->length);
+        return result;
+    }
+
+    bool Reduce(bool (*func)(const bool&, const bool&), const bool& initial) const override {
+        SEQUENCE_TRACE_SCOPE("Reduce", "BitSequence");
+        bool result = initial;
+        for (int i = 0; i < length; ++i) {
+            result = func(result, GetBit(i));
+        }
+        return result;
+    }
+
+    Sequence<bool>* FlatMap(Sequence<bool>* (*func)(const bool&)) const override {
+        BitSequence* result = new BitSequence();
+        for (int i = 0; i < length; ++i) {
+            Sequence<bool>* subseq = func(GetBit(i));
+            result->AppendAll(subseq);
+            delete subseq;
+        }
+        return result;
+    }
+
+    Sequence<bool>* FlatMap(void (*func)(const bool&, ISequenceSink<bool>&)) const override {
+        BitSequence* result = new BitSequence();
+        BitSink sink(*result);
+        for (int i = 0; i < length; ++i) {
+            func(GetBit(i), sink);
+        }
+        return result;
+    }
+
+    Option<bool> Find(bool (*predicate)(const bool&)) const override {
+        bool acceptFalse = predicate(false);
+        bool acceptTrue = predicate(true);
+        if (length > 0 && acceptFalse && acceptTrue) {
+            return Option<bool>::Some(GetBit(0));
+        }
+        if (acceptTrue && FindNextSet() >= 0) {
+            return Option<bool>::Some(true);
+        }
+        if (acceptFalse && FindNextClear() >= 0) {
+            return Option<bool>::Some(false);
+        }
+        return Option<bool>::None();
+    }
+
+    std::pair<Sequence<bool>*, Sequence<bool>*> Split(bool (*predicate)(const bool&)) const override {
+        bool keepFalse = predicate(false);
+        bool keepTrue = predicate(true);
+        if (keepFalse == keepTrue) {
+            BitSequence* all = new BitSequence(*this);
+            BitSequence* none = new BitSequence();
+            return keepTrue ? std::make_pair(all, none) : std::make_pair(none, all);
+        }
+        BitSequence* ones = new BitSequence(CountOnes(), true);
+        BitSequence* zeros = new BitSequence(CountZeros(), false);
+        return keepTrue ? std::make_pair(ones, zeros) : std::make_pair(zeros, ones);
+    }
+
+    Sequence<bool>* Concat(const Sequence<bool>* other) const override {
+        BitSequence* result = new BitSequence(*this);
+        result->AppendAll(other);
+        return result;
+    }
+
+    Sequence<bool>* Slice(int i, int N, const Sequence<bool>* s = nullptr) const override {
+        if (i < 0) {
+            i = length + i;
+        }
+        if (i < 0 || i >= length) {
+            throw IndexOutOfRangeException("Invalid slice index");
+        }
+        if (i + N > length) {
+            N = length - i;
+        }
+
+        BitSequence* result = new BitSequence();
+        result->AppendRange(*this, 0, i);
+        if (s != nullptr) {
+            result->AppendAll(s);
+        }
+        result->AppendRange(*this, i + N, length);
+        return result;
+    }
+
+    MemoryUsage MemoryFootprint() const override {
+        MemoryUsage usage;
+        usage.payloadBytes = (static_cast<long long>(length) + 7) / 8;
+        usage.slackBytes = static_cast<long long>(sizeof(std::uint64_t)) * words.GetCapacity() - usage.payloadBytes;
+        return usage;
+    }
+
+    IEnumerator<bool>* GetEnumerator() const override {
+        SEQUENCE_COUNT(EnumeratorAllocations, 1);
+        return new BitSequenceEnumerator(*this);
+    }
+};
@@ -0,0 +1,160 @@
+#pragma once
+#include <chrono>
+#include <istream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "DynamicArray.hpp"
+#include "LinkedList.hpp"
+#include "SequenceSink.hpp"
+#include "ArraySequence.hpp"
+#include "ListSequence.hpp"
+#include "ImmutableArraySequence.hpp"
+#include "ImmutableListSequence.hpp"
+#include "Exceptions.hpp"
+
+// Статистика последней загрузки
+struct LoadStats {
+    long long bytesRead = 0;
+    long long valuesParsed = 0;
+    double seconds = 0.0;
+
+    double GetMegabytesPerSecond() const {
+        return seconds > 0.0 ? bytesRead / seconds / (1024.0 * 1024.0) : 0.0;
+    }
+
+    double GetValuesPerSecond() const {
+        return seconds > 0.0 ? valuesParsed / seconds : 0.0;
+    }
+};
+
+// Загрузка больших наборов целых чисел, разделённых пробелами и переводами строк.
+// Поток читается блоками через rdbuf()->sgetn, числа разбираются вручную и сразу
+// попадают в итоговое хранилище последовательности — без промежуточного массива.
+// Читает поток до конца, поэтому не подходит для интерактивного ввода.
+template <typename T>
+class BulkLoader {
+    static_assert(std::is_integral<T>::value, "BulkLoader parses integers only");
+
+private:
+    using Magnitude = unsigned long long;
+
+    std::istream& input;
+    int bufferSize;
+    LoadStats stats;
+
+    static T ToValue(Magnitude magnitude, bool negative) {
+        if constexpr (std::is_signed<T>::value) {
+            if (negative && magnitude > 0) {
+                // -(magnitude - 1) - 1 не переполняется и для минимального значения типа
+                return static_cast<T>(-static_cast<T>(magnitude - 1) - 1);
+            }
+        }
+        return static_cast<T>(magnitude);
+    }
+
+public:
+    explicit BulkLoader(std::istream& input, int bufferSize = 1 << 20) : input(input), bufferSize(bufferSize) {
+        if (bufferSize <= 0) {
+            throw InvalidSizeException("Buffer size must be positive");
+        }
+    }
+
+    // Разбирает весь поток и передаёт числа в sink
+    void LoadInto(ISequenceSink<T>& sink) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        stats = LoadStats();
+
+        const Magnitude positiveLimit = static_cast<Magnitude>(std::numeric_limits<T>::max());
+        const Magnitude negativeLimit = positiveLimit + (std::is_signed<T>::value ? 1 : 0);
+
+        DynamicArray<char> buffer(bufferSize);
+        char* data = buffer.GetData();
+        Magnitude magnitude = 0;
+        Magnitude limit = positiveLimit;
+        bool inNumber = false;
+        bool hasDigits = false;
+        bool negative = false;
+
+        while (true) {
+            std::streamsize got = input.rdbuf()->sgetn(data, bufferSize);
+            if (got <= 0) {
+                break;
+            }
+            for (std::streamsize i = 0; i < got; ++i) {
+                unsigned char c = static_cast<unsigned char>(data[i]);
+                unsigned digit = c - static_cast<unsigned>('0');
+                if (digit < 10) {
+                    if (magnitude > (limit - digit) / 10) {
+                        throw InvalidArgumentException("Value out of range at byte " + std::to_string(stats.bytesRead + i));
+                    }
+                    magnitude = magnitude * 10 + digit;
+                    inNumber = true;
+                    hasDigits = true;
+                } else if (c == ' ' || c == '\n' || c == '\t' || c == '\r') {
+                    if (inNumber) {
+                        if (!hasDigits) {
+                            throw InvalidArgumentException("Sign without digits at byte " + std::to_string(stats.bytesRead + i));
+                        }
+                        sink.Push(ToValue(magnitude, negative));
+                        ++stats.valuesParsed;
+                        magnitude = 0;
+                        inNumber = false;
+                        hasDigits = false;
+                        negative = false;
+                        limit = positiveLimit;
+                    }
+                } else if (!inNumber && (c == '+' || (c == '-' && std::is_signed<T>::value))) {
+                    inNumber = true;
+                    negative = c == '-';
+                    limit = negative ? negativeLimit : positiveLimit;
+                } else {
+                    throw InvalidArgumentException("Unexpected character at byte " + std::to_string(stats.bytesRead + i));
+                }
+            }
+            stats.bytesRead += got;
+        }
+        if (inNumber) {
+            if (!hasDigits) {
+                throw InvalidArgumentException("Sign without digits at end of input");
+            }
+            sink.Push(ToValue(magnitude, negative));
+            ++stats.valuesParsed;
+        }
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    ArraySequence<T>* LoadArraySequence() {
+        DynamicArray<T> items;
+        DynamicArraySink<T> sink(items);
+        LoadInto(sink);
+        return new ArraySequence<T>(std::move(items));
+    }
+
+    ImmutableArraySequence<T>* LoadImmutableArraySequence() {
+        DynamicArray<T> items;
+        DynamicArraySink<T> sink(items);
+        LoadInto(sink);
+        return new ImmutableArraySequence<T>(std::move(items));
+    }
+
+    ListSequence<T>* LoadListSequence() {
+        LinkedList<T> items;
+        LinkedListSink<T> sink(items);
+        LoadInto(sink);
+        return new ListSequence<T>(std::move(items));
+    }
+
+    ImmutableListSequence<T>* LoadImmutableListSequence() {
+        LinkedList<T> items;
+        LinkedListSink<T> sink(items);
+        LoadInto(sink);
+        return new ImmutableListSequence<T>(std::move(items));
+    }
+
+    const LoadStats& GetStats() const {
+        return stats;
+    }
+};
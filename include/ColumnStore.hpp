@@ -0,0 +1,258 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <utility>
+#include "DynamicArray.hpp"
+#include "ArraySequence.hpp"
+#include "ReadOnlySequence.hpp"
+#include "Exceptions.hpp"
+
+// Набор номеров строк, прошедших фильтр. Позволяет сочетать условия
+// по разным столбцам, не материализуя промежуточные записи. Границы номеров
+// запоминаются при создании, чтобы хранилище проверяло выборку за O(1).
+class SelectionVector {
+private:
+    DynamicArray<int> rows;
+    int minRow;
+    int maxRow;
+
+public:
+    SelectionVector() : minRow(0), maxRow(-1) {}
+
+    explicit SelectionVector(DynamicArray<int>&& rows) : rows(std::move(rows)), minRow(0), maxRow(-1) {
+        const int* items = this->rows.GetData();
+        for (int i = 0; i < this->rows.GetSize(); ++i) {
+            if (i == 0 || items[i] < minRow) {
+                minRow = items[i];
+            }
+            if (i == 0 || items[i] > maxRow) {
+                maxRow = items[i];
+            }
+        }
+    }
+
+    // Все номера лежат в [0, rowCount)
+    bool FitsRows(int rowCount) const {
+        return rows.GetSize() == 0 || (minRow >= 0 && maxRow < rowCount);
+    }
+
+    int GetCount() const {
+        return rows.GetSize();
+    }
+
+    int Get(int index) const {
+        return rows.Get(index);
+    }
+
+    const int* GetData() const {
+        return rows.GetData();
+    }
+};
+
+template <typename... Ts>
+class ColumnStore;
+
+// Представление хранилища как Sequence строк; строки собираются по запросу
+template <typename... Ts>
+class ColumnRowView : public ReadOnlySequence<std::tuple<Ts...>> {
+private:
+    const ColumnStore<Ts...>& store;
+    const SelectionVector* selection;
+
+public:
+    ColumnRowView(const ColumnStore<Ts...>& store, const SelectionVector* selection = nullptr)
+        : store(store), selection(selection) {}
+
+    std::tuple<Ts...> Get(int index) const override {
+        if (index < 0 || index >= GetLength()) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        return store.GetRow(selection ? selection->Get(index) : index);
+    }
+
+    int GetLength() const override {
+        return selection ? selection->GetCount() : store.GetRowCount();
+    }
+};
+
+// Столбцовое хранилище записей из нескольких числовых полей, у каждого поля свой тип:
+// ColumnStore<int, long long, double>. Каждое поле лежит в своём DynamicArray, поэтому
+// проход по одному полю читает только его память, а узкие поля не расширяются до
+// самого широкого. Номер столбца в операциях — параметр шаблона: тип результата
+// зависит от столбца. Строка — std::tuple<Ts...>.
+template <typename... Ts>
+class ColumnStore {
+    static_assert(sizeof...(Ts) > 0, "Column store needs at least one column");
+
+public:
+    static constexpr int ColumnCount = static_cast<int>(sizeof...(Ts));
+
+    using Row = std::tuple<Ts...>;
+
+    template <int Column>
+    using ColumnType = typename std::tuple_element<Column, Row>::type;
+
+private:
+    std::tuple<DynamicArray<Ts>...> columns;
+    DynamicArray<std::string> names;
+    int rowCount;
+
+    void CheckColumn(int column) const {
+        if (column < 0 || column >= ColumnCount) {
+            throw IndexOutOfRangeException("Invalid column index");
+        }
+    }
+
+    void CheckSelection(const SelectionVector* selection) const {
+        if (selection && !selection->FitsRows(rowCount)) {
+            throw IndexOutOfRangeException("Selection refers to a missing row");
+        }
+    }
+
+    template <typename Column>
+    void Reserve(Column& column, int capacity) {
+        column.Reserve(capacity);
+    }
+
+    template <typename Column, typename Value>
+    void Store(Column& column, const Value& value) {
+        column.Resize(rowCount + 1);
+        column.GetData()[rowCount] = value;
+    }
+
+    template <std::size_t... Indices>
+    void ReserveAll(int capacity, std::index_sequence<Indices...>) {
+        (Reserve(std::get<Indices>(columns), capacity), ...);
+    }
+
+    template <std::size_t... Indices>
+    void StoreAll(const Row& values, std::index_sequence<Indices...>) {
+        (Store(std::get<Indices>(columns), std::get<Indices>(values)), ...);
+    }
+
+    template <std::size_t... Indices>
+    Row RowAt(int row, std::index_sequence<Indices...>) const {
+        return Row(std::get<Indices>(columns).GetData()[row]...);
+    }
+
+public:
+    // columnNames должен содержать ColumnCount имён
+    ColumnStore(const std::string* columnNames, int columnCount) : names(columnNames, columnCount), rowCount(0) {
+        if (columnCount != ColumnCount) {
+            throw InvalidSizeException("Column name count does not match column types");
+        }
+    }
+
+    int GetColumnCount() const {
+        return ColumnCount;
+    }
+
+    int GetRowCount() const {
+        return rowCount;
+    }
+
+    int GetColumnIndex(const std::string& name) const {
+        for (int i = 0; i < names.GetSize(); ++i) {
+            if (names[i] == name) {
+                return i;
+            }
+        }
+        throw InvalidArgumentException("Unknown column: " + name);
+    }
+
+    const std::string& GetColumnName(int column) const {
+        CheckColumn(column);
+        return names[column];
+    }
+
+    template <int Column>
+    const DynamicArray<ColumnType<Column>>& GetColumn() const {
+        return std::get<Column>(columns);
+    }
+
+    void AppendRow(const Ts&... values) {
+        AppendRow(Row(values...));
+    }
+
+    void AppendRow(const Row& values) {
+        if (rowCount == std::get<0>(columns).GetCapacity()) {
+            ReserveAll(rowCount < 8 ? 8 : rowCount * 2, std::index_sequence_for<Ts...>());
+        }
+        StoreAll(values, std::index_sequence_for<Ts...>());
+        ++rowCount;
+    }
+
+    template <int Column>
+    ColumnType<Column> Get(int row) const {
+        return std::get<Column>(columns).Get(row);
+    }
+
+    Row GetRow(int row) const {
+        if (row < 0 || row >= rowCount) {
+            throw IndexOutOfRangeException("Invalid row index");
+        }
+        return RowAt(row, std::index_sequence_for<Ts...>());
+    }
+
+    template <int Column>
+    Sequence<ColumnType<Column>>* MapColumn(ColumnType<Column> (*func)(const ColumnType<Column>&)) const {
+        const ColumnType<Column>* source = std::get<Column>(columns).GetData();
+        DynamicArray<ColumnType<Column>> result(rowCount);
+        ColumnType<Column>* items = result.GetData();
+        for (int i = 0; i < rowCount; ++i) {
+            items[i] = func(source[i]);
+        }
+        return new ArraySequence<ColumnType<Column>>(std::move(result));
+    }
+
+    // Фильтр по одному столбцу; если задан input, проверяются только его строки
+    template <int Column>
+    SelectionVector WhereColumn(bool (*predicate)(const ColumnType<Column>&),
+                                const SelectionVector* input = nullptr) const {
+        CheckSelection(input);
+        const ColumnType<Column>* source = std::get<Column>(columns).GetData();
+        DynamicArray<int> rows;
+        DynamicArraySink<int> sink(rows);
+        if (input) {
+            const int* candidates = input->GetData();
+            for (int i = 0; i < input->GetCount(); ++i) {
+                if (predicate(source[candidates[i]])) {
+                    sink.Push(candidates[i]);
+                }
+            }
+        } else {
+            for (int i = 0; i < rowCount; ++i) {
+                if (predicate(source[i])) {
+                    sink.Push(i);
+                }
+            }
+        }
+        return SelectionVector(std::move(rows));
+    }
+
+    template <int Column>
+    ColumnType<Column> ReduceColumn(ColumnType<Column> (*func)(const ColumnType<Column>&, const ColumnType<Column>&),
+                                    const ColumnType<Column>& initial,
+                                    const SelectionVector* selection = nullptr) const {
+        CheckSelection(selection);
+        const ColumnType<Column>* source = std::get<Column>(columns).GetData();
+        ColumnType<Column> result = initial;
+        if (selection) {
+            const int* rows = selection->GetData();
+            for (int i = 0; i < selection->GetCount(); ++i) {
+                result = func(result, source[rows[i]]);
+            }
+        } else {
+            for (int i = 0; i < rowCount; ++i) {
+                result = func(result, source[i]);
+            }
+        }
+        return result;
+    }
+
+    // selection должен жить дольше представления
+    ColumnRowView<Ts...> GetRows(const SelectionVector* selection = nullptr) const {
+        return ColumnRowView<Ts...>(*this, selection);
+    }
+};
@@ -0,0 +1,386 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include "ReadOnlySequence.hpp"
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+
+// Сжатая последовательность int только для чтения. Элементы хранятся блоками по 128:
+// в каждом блоке значения записаны либо как отступ от минимума блока (frame of
+// reference), либо — для неубывающих блоков, если так выходит уже, — как разности
+// соседних значений. Отступы упакованы одинаковым для блока числом бит.
+// Упаковка вертикальная, в четыре полосы: значение i лежит в полосе i % 4, и строка из
+// четырёх соседних значений распаковывается одинаковыми сдвигами — такой цикл
+// компилятор переводит в SIMD без интринсиков. Заголовки блоков служат индексом
+// пропуска: блок элемента находится за O(1), Get внутри блока с отступами — O(1),
+// с разностями — префиксная сумма до элемента. Reduce, Find, Map, Where и
+// перечисление распаковывают блок целиком.
+class CompressedIntSequence : public ReadOnlySequence<int> {
+public:
+    static constexpr int BlockSize = 128;
+
+private:
+    static constexpr int Lanes = 4;
+    static constexpr int RowsPerBlock = BlockSize / Lanes;
+
+    struct Block {
+        int base;             // минимум блока или первое значение для разностей
+        std::uint32_t offset; // первое слово блока в words
+        std::uint8_t width;   // бит на значение, 0..32
+        bool delta;
+    };
+
+    class CompressedEnumerator : public IEnumerator<int> {
+    private:
+        const CompressedIntSequence& sequence;
+        int currentIndex;
+        int decodedBlock;
+        int values[BlockSize];
+
+    public:
+        explicit CompressedEnumerator(const CompressedIntSequence& sequence)
+            : sequence(sequence), currentIndex(-1), decodedBlock(-1) {}
+
+        bool MoveNext() override {
+            if (currentIndex + 1 >= sequence.length) {
+                return false;
+            }
+            currentIndex++;
+            int block = currentIndex / BlockSize;
+            if (block != decodedBlock) {
+                sequence.DecodeBlock(block, values);
+                decodedBlock = block;
+            }
+            return true;
+        }
+
+        const int& Current() const override {
+            if (currentIndex < 0 || currentIndex >= sequence.length) {
+                throw InvalidStateException("Enumerator is not in a valid position");
+            }
+            return values[currentIndex % BlockSize];
+        }
+
+        void Reset() override {
+            currentIndex = -1;
+        }
+    };
+
+    DynamicArray<std::uint32_t> words;
+    DynamicArray<Block> blocks;
+    int length;
+
+    static int GetBitWidth(std::uint32_t value) {
+        int width = 0;
+        while (value != 0) {
+            ++width;
+            value >>= 1;
+        }
+        return width;
+    }
+
+    static std::uint32_t GetMask(int width) {
+        return width == 32 ? 0xFFFFFFFFu : (1u << width) - 1;
+    }
+
+    // Отступ номер position в полосе lane
+    static std::uint32_t Extract(const std::uint32_t* data, int width, int lane, int position) {
+        int bit = position * width;
+        int word = bit >> 5;
+        int shift = bit & 31;
+        std::uint32_t value = data[word * Lanes + lane] >> shift;
+        if (shift + width > 32) {
+            value |= data[(word + 1) * Lanes + lane] << (32 - shift);
+        }
+        return value & GetMask(width);
+    }
+
+    // Распаковывает все 128 отступов блока; строка — одна и та же операция над четырьмя полосами
+    static void Unpack(const std::uint32_t* data, int width, std::uint32_t* out) {
+        if (width == 0) {
+            for (int i = 0; i < BlockSize; ++i) {
+                out[i] = 0;
+            }
+            return;
+        }
+        std::uint32_t mask = GetMask(width);
+        for (int row = 0; row < RowsPerBlock; ++row) {
+            int bit = row * width;
+            int word = bit >> 5;
+            int shift = bit & 31;
+            const std::uint32_t* low = data + word * Lanes;
+            std::uint32_t* target = out + row * Lanes;
+            if (shift + width > 32) {
+                const std::uint32_t* high = low + Lanes;
+                for (int lane = 0; lane < Lanes; ++lane) {
+                    target[lane] = ((low[lane] >> shift) | (high[lane] << (32 - shift))) & mask;
+                }
+            } else {
+                for (int lane = 0; lane < Lanes; ++lane) {
+                    target[lane] = (low[lane] >> shift) & mask;
+                }
+            }
+        }
+    }
+
+    static void Pack(const std::uint32_t* values, int width, std::uint32_t* data) {
+        if (width == 0) {
+            return;
+        }
+        for (int i = 0; i < Lanes * width; ++i) {
+            data[i] = 0;
+        }
+        for (int row = 0; row < RowsPerBlock; ++row) {
+            int bit = row * width;
+            int word = bit >> 5;
+            int shift = bit & 31;
+            for (int lane = 0; lane < Lanes; ++lane) {
+                std::uint32_t value = values[row * Lanes + lane];
+                data[word * Lanes + lane] |= value << shift;
+                if (shift + width > 32) {
+                    data[(word + 1) * Lanes + lane] |= value >> (32 - shift);
+                }
+            }
+        }
+    }
+
+    // Кодирует count (<= 128) значений в новый блок
+    void AppendBlock(const int* values, int count) {
+        std::uint32_t offsets[BlockSize];
+        int minimum = values[0];
+        bool sorted = true;
+        std::uint32_t maxDelta = 0;
+        for (int i = 0; i < count; ++i) {
+            minimum = values[i] < minimum ? values[i] : minimum;
+            if (i > 0) {
+                sorted = sorted && values[i] >= values[i - 1];
+                std::uint32_t delta = static_cast<std::uint32_t>(values[i]) - static_cast<std::uint32_t>(values[i - 1]);
+                maxDelta = delta > maxDelta ? delta : maxDelta;
+            }
+        }
+        std::uint32_t maxOffset = 0;
+        for (int i = 0; i < count; ++i) {
+            std::uint32_t offset = static_cast<std::uint32_t>(values[i]) - static_cast<std::uint32_t>(minimum);
+            maxOffset = offset > maxOffset ? offset : maxOffset;
+        }
+
+        Block block;
+        block.delta = sorted && GetBitWidth(maxDelta) < GetBitWidth(maxOffset);
+        block.base = block.delta ? values[0] : minimum;
+        block.width = static_cast<std::uint8_t>(GetBitWidth(block.delta ? maxDelta : maxOffset));
+        block.offset = static_cast<std::uint32_t>(words.GetSize());
+        for (int i = 0; i < BlockSize; ++i) {
+            if (i >= count) {
+                offsets[i] = 0;
+            } else if (block.delta) {
+                offsets[i] = i == 0 ? 0 : static_cast<std::uint32_t>(values[i]) - static_cast<std::uint32_t>(values[i - 1]);
+            } else {
+                offsets[i] = static_cast<std::uint32_t>(values[i]) - static_cast<std::uint32_t>(minimum);
+            }
+        }
+
+        int oldWords = words.GetSize();
+        int newWords = oldWords + Lanes * block.width;
+        if (newWords > words.GetCapacity()) {
+            words.Reserve(newWords < 2 * words.GetCapacity() ? 2 * words.GetCapacity() : newWords);
+        }
+        words.Resize(newWords);
+        Pack(offsets, block.width, words.GetData() + oldWords);
+
+        int blockIndex = blocks.GetSize();
+        if (blockIndex == blocks.GetCapacity()) {
+            blocks.Reserve(blockIndex < 8 ? 8 : blockIndex * 2);
+        }
+        blocks.Resize(blockIndex + 1);
+        blocks[blockIndex] = block;
+        length += count;
+    }
+
+    int GetBlockLength(int block) const {
+        int begin = block * BlockSize;
+        return length - begin < BlockSize ? length - begin : BlockSize;
+    }
+
+    // Все значения блока; за последним элементом в неполном блоке — мусор
+    void DecodeBlock(int index, int* out) const {
+        const Block& block = blocks[index];
+        std::uint32_t offsets[BlockSize];
+        Unpack(words.GetData() + block.offset, block.width, offsets);
+        std::uint32_t base = static_cast<std::uint32_t>(block.base);
+        if (block.delta) {
+            std::uint32_t current = base;
+            for (int i = 0; i < BlockSize; ++i) {
+                current += offsets[i];
+                out[i] = static_cast<int>(current);
+            }
+        } else {
+            for (int i = 0; i < BlockSize; ++i) {
+                out[i] = static_cast<int>(base + offsets[i]);
+            }
+        }
+    }
+
+    void Encode(const int* items, int count) {
+        if (count < 0) {
+            throw InvalidSizeException("Count cannot be negative");
+        }
+        for (int begin = 0; begin < count; begin += BlockSize) {
+            AppendBlock(items + begin, count - begin < BlockSize ? count - begin : BlockSize);
+        }
+    }
+
+protected:
+    void CopyRangeInto(int begin, int end, DynamicArray<int>& result) const override {
+        result = DynamicArray<int>(end - begin);
+        int* target = result.GetData();
+        int values[BlockSize];
+        for (int index = begin; index < end;) {
+            int block = index / BlockSize;
+            int offset = index % BlockSize;
+            int count = BlockSize - offset < end - index ? BlockSize - offset : end - index;
+            DecodeBlock(block, values);
+            for (int i = 0; i < count; ++i) {
+                target[index - begin + i] = values[offset + i];
+            }
+            index += count;
+        }
+    }
+
+public:
+    CompressedIntSequence() : length(0) {}
+
+    CompressedIntSequence(const int* items, int count) : length(0) {
+        Encode(items, count);
+    }
+
+    explicit CompressedIntSequence(const DynamicArray<int>& items) : length(0) {
+        Encode(items.GetData(), items.GetSize());
+    }
+
+    // Сжимает поток по блоку, не держа копию всей последовательности
+    explicit CompressedIntSequence(const Sequence<int>& source) : length(0) {
+        int values[BlockSize];
+        int filled = 0;
+        IEnumerator<int>* enumerator = source.GetEnumerator();
+        while (enumerator->MoveNext()) {
+            values[filled++] = enumerator->Current();
+            if (filled == BlockSize) {
+                AppendBlock(values, filled);
+                filled = 0;
+            }
+        }
+        delete enumerator;
+        if (filled > 0) {
+            AppendBlock(values, filled);
+        }
+    }
+
+    int Get(int index) const override {
+        if (index < 0 || index >= length) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        const Block& block = blocks[index / BlockSize];
+        const std::uint32_t* data = words.GetData() + block.offset;
+        int position = index % BlockSize;
+        std::uint32_t value = static_cast<std::uint32_t>(block.base);
+        if (block.width == 0) {
+            return static_cast<int>(value);
+        }
+        if (!block.delta) {
+            return static_cast<int>(value + Extract(data, block.width, position % Lanes, position / Lanes));
+        }
+        for (int i = 1; i <= position; ++i) {
+            value += Extract(data, block.width, i % Lanes, i / Lanes);
+        }
+        return static_cast<int>(value);
+    }
+
+    int GetLength() const override {
+        return length;
+    }
+
+    // Средняя ширина упаковки, бит на элемент (без заголовков блоков)
+    double GetBitsPerElement() const {
+        return length > 0 ? 32.0 * words.GetSize() / length : 0.0;
+    }
+
+    MemoryUsage MemoryFootprint() const override {
+        MemoryUsage usage;
+        usage.payloadBytes = static_cast<long long>(sizeof(std::uint32_t)) * words.GetSize();
+        usage.slackBytes = static_cast<long long>(sizeof(std::uint32_t)) * (words.GetCapacity() - words.GetSize()) +
+                           static_cast<long long>(sizeof(Block)) * (blocks.GetCapacity() - blocks.GetSize());
+        usage.overheadBytes = static_cast<long long>(sizeof(Block)) * blocks.GetSize();
+        return usage;
+    }
+
+    Sequence<int>* Map(int (*func)(const int&)) const override {
+        SEQUENCE_TRACE_SCOPE("Map", "CompressedIntSequence");
+        DynamicArray<int> result;
+        CopyRangeInto(0, length, result);
+        int* items = result.GetData();
+        for (int i = 0; i < length; ++i) {
+            items[i] = func(items[i]);
+        }
+        SEQUENCE_TRACE_OUTPUT(length);
+        return new ArraySequence<int>(std::move(result));
+    }
+
+    Sequence<int>* Where(bool (*predicate)(const int&)) const override {
+        SEQUENCE_TRACE_SCOPE("Where", "CompressedIntSequence");
+        DynamicArray<int> result;
+        DynamicArraySink<int> sink(result);
+        int values[BlockSize];
+        for (int block = 0; block < blocks.GetSize(); ++block) {
+            DecodeBlock(block, values);
+            int count = GetBlockLength(block);
+            for (int i = 0; i < count; ++i) {
+                if (predicate(values[i])) {
+                    sink.Push(values[i]);
+                }
+            }
+        }
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ArraySequence<int>(std::move(result));
+    }
+
+    int Reduce(int (*func)(const int&, const int&), const int& initial) const override {
+        SEQUENCE_TRACE_SCOPE("Reduce", "CompressedIntSequence");
+        int result = initial;
+        int values[BlockSize];
+        for (int block = 0; block < blocks.GetSize(); ++block) {
+            DecodeBlock(block, values);
+            int count = GetBlockLength(block);
+            for (int i = 0; i < count; ++i) {
+                result = func(result, values[i]);
+            }
+        }
+        return result;
+    }
+
+    Option<int> Find(bool (*predicate)(const int&)) const override {
+        SEQUENCE_TRACE_SCOPE("Find", "CompressedIntSequence");
+        int values[BlockSize];
+        for (int block = 0; block < blocks.GetSize(); ++block) {
+            DecodeBlock(block, values);
+            int count = GetBlockLength(block);
+            for (int i = 0; i < count; ++i) {
+                if (predicate(values[i])) {
+                    return Option<int>::Some(values[i]);
+                }
+            }
+        }
+        return Option<int>::None();
+    }
+
+    // Распаковывает всё в обычный массив
+    ArraySequence<int>* Decompress() const {
+        DynamicArray<int> result;
+        CopyRangeInto(0, length, result);
+        return new ArraySequence<int>(std::move(result));
+    }
+
+    IEnumerator<int>* GetEnumerator() const override {
+        SEQUENCE_COUNT(EnumeratorAllocations, 1);
+        return new CompressedEnumerator(*this);
+    }
+};
@@ -1,12 +1,21 @@
 #pragma once
+#include <utility>
 #include "Exceptions.hpp"
+#include "Instrumentation.hpp"
+#include "MemoryTracker.hpp"
 
 template <typename T>
 class DynamicArray {
 private:
     T* items;
     int size;
-    int capacity;  // для будущего)
+    int capacity;
+
+    // Освобождает хранилище и снимает его с учёта MemoryTracker
+    void ReleaseItems() {
+        delete[] items;
+        MemoryTracker::OnFree(static_cast<long long>(sizeof(T)) * capacity);
+    }
 
 public:
     DynamicArray() : items(nullptr), size(0), capacity(0) {}
@@ -18,15 +27,18 @@ public:
         this->size = count;
         this->capacity = count;
         this->items = new T[count];
+        MemoryTracker::OnAllocate(static_cast<long long>(sizeof(T)) * count);
         for (int i = 0; i < count; i++) {
             this->items[i] = items[i];
         }
+        SEQUENCE_COUNT(BytesCopied, sizeof(T) * count);
     }
     DynamicArray(int size) : size(size), capacity(size) {
         if (size < 0) {
             throw InvalidSizeException("Size cannot be negative");
         }
         this->items = size > 0 ? new T[size]() : nullptr;
+        MemoryTracker::OnAllocate(static_cast<long long>(sizeof(T)) * size);
     }
     // from
     DynamicArray(const DynamicArray<T>& other) : size(other.size), capacity(other.size) {
@@ -35,14 +47,23 @@ public:
             return;
         }
         items = new T[size];
+        MemoryTracker::OnAllocate(static_cast<long long>(sizeof(T)) * size);
         for (int i = 0; i < size; ++i) {
             items[i] = other.items[i];
         }
+        SEQUENCE_COUNT(BytesCopied, sizeof(T) * size);
+    }
+
+    DynamicArray(DynamicArray<T>&& other) noexcept
+        : items(other.items), size(other.size), capacity(other.capacity) {
+        other.items = nullptr;
+        other.size = 0;
+        other.capacity = 0;
     }
 
     DynamicArray& operator=(const DynamicArray<T>& other) {
         if (this != &other) {
-            delete[] items;
+            ReleaseItems();
             size = other.size;
             capacity = other.size;
             if (size == 0) {
@@ -50,15 +71,30 @@ public:
                 return *this;
             }
             items = new T[size];
+            MemoryTracker::OnAllocate(static_cast<long long>(sizeof(T)) * size);
             for (int i = 0; i < size; ++i) {
                 items[i] = other.items[i];
             }
+            SEQUENCE_COUNT(BytesCopied, sizeof(T) * size);
+        }
+        return *this;
+    }
+
+    DynamicArray& operator=(DynamicArray<T>&& other) noexcept {
+        if (this != &other) {
+            ReleaseItems();
+            items = other.items;
+            size = other.size;
+            capacity = other.capacity;
+            other.items = nullptr;
+            other.size = 0;
+            other.capacity = 0;
         }
         return *this;
     }
 
     ~DynamicArray() {
-        delete[] items;
+        ReleaseItems();
     }
 
     T Get(int index) const {
@@ -72,6 +108,15 @@ public:
         return size;
     }
 
+    // Прямой доступ к хранилищу для массовых операций без проверки индексов
+    T* GetData() {
+        return items;
+    }
+
+    const T* GetData() const {
+        return items;
+    }
+
     void Set(int index, const T& value) {
         if (index < 0 || index >= size) {
             throw IndexOutOfRangeException("Index out of range");
@@ -79,28 +124,63 @@ public:
         items[index] = value;
     }
 
+    int GetCapacity() const {
+        return capacity;
+    }
+
     void Resize(int newSize) {
         if (newSize < 0) {
             throw InvalidSizeException("New size cannot be negative");
         }
+        SEQUENCE_COUNT(ArrayResizeCalls, 1);
         if (newSize == 0) {
-            delete[] items;
+            ReleaseItems();
             items = nullptr;
             size = 0;
             capacity = 0;
             return;
         }
+        if (newSize <= capacity) {
+            for (int i = size; i < newSize; ++i) {
+                items[i] = T();
+            }
+            size = newSize;
+            return;
+        }
         T* newItems = new T[newSize]();
+        MemoryTracker::OnAllocate(static_cast<long long>(sizeof(T)) * newSize);
         int copySize = newSize < size ? newSize : size;
         for (int i = 0; i < copySize; ++i) {
-            newItems[i] = items[i];
+            newItems[i] = std::move(items[i]);
         }
-        delete[] items;
+        SEQUENCE_COUNT(ArrayReallocations, 1);
+        SEQUENCE_COUNT(BytesCopied, sizeof(T) * copySize);
+        ReleaseItems();
         items = newItems;
         size = newSize;
         capacity = newSize;
     }
 
+    // Выделяет ёмкость заранее, не меняя размер
+    void Reserve(int newCapacity) {
+        if (newCapacity < 0) {
+            throw InvalidSizeException("Capacity cannot be negative");
+        }
+        if (newCapacity <= capacity) {
+            return;
+        }
+        T* newItems = new T[newCapacity]();
+        MemoryTracker::OnAllocate(static_cast<long long>(sizeof(T)) * newCapacity);
+        for (int i = 0; i < size; ++i) {
+            newItems[i] = std::move(items[i]);
+        }
+        SEQUENCE_COUNT(ArrayReallocations, 1);
+        SEQUENCE_COUNT(BytesCopied, sizeof(T) * size);
+        ReleaseItems();
+        items = newItems;
+        capacity = newCapacity;
+    }
+
     T& operator[](int index) {
         if (index < 0 || index >= size) {
             throw IndexOutOfRangeException("Index out of range");
@@ -41,4 +41,9 @@ public:
 class InvalidStateException : public SequenceException {
 public:
     explicit InvalidStateException(const std::string& message) : SequenceException(message) {}
-};
\ No newline at end of file
+};
+
+class SerializationException : public SequenceException {
+public:
+    explicit SerializationException(const std::string& message) : SequenceException(message) {}
+};
@@ -0,0 +1,636 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <unistd.h>
+#include "Sequence.hpp"
+#include "DynamicArray.hpp"
+#include "SequenceSink.hpp"
+#include "ArraySequence.hpp"
+#include "SpillableSequence.hpp"
+#include "SequenceSerialization.hpp"
+#include "TempFile.hpp"
+#include "Exceptions.hpp"
+
+// Фоновый поток ввода-вывода: операции выполняются по очереди, результат ждут через future.
+// Пока поток читает следующий блок прогона, слияние разбирает текущий.
+class BackgroundFileIO {
+private:
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::queue<std::packaged_task<void()>> tasks;
+    bool stopping;
+
+    void WorkerLoop() {
+        while (true) {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty()) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::future<void> Submit(std::function<void()> operation) {
+        std::packaged_task<void()> task(std::move(operation));
+        std::future<void> result = task.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push(std::move(task));
+        }
+        ready.notify_one();
+        return result;
+    }
+
+public:
+    BackgroundFileIO() : stopping(false) {
+        worker = std::thread([this] { WorkerLoop(); });
+    }
+
+    BackgroundFileIO(const BackgroundFileIO&) = delete;
+    BackgroundFileIO& operator=(const BackgroundFileIO&) = delete;
+
+    // Оставшиеся в очереди операции выполняются до выхода потока
+    ~BackgroundFileIO() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        ready.notify_one();
+        worker.join();
+    }
+
+    std::future<void> ReadAt(int fd, void* data, long long bytes, long long offset) {
+        return Submit([fd, data, bytes, offset] { ReadFileAt(fd, data, bytes, offset); });
+    }
+
+    std::future<void> WriteAt(int fd, const void* data, long long bytes, long long offset) {
+        return Submit([fd, data, bytes, offset] { WriteFileAt(fd, data, bytes, offset); });
+    }
+};
+
+// Счётчики последней сортировки
+struct ExternalSortStats {
+    int initialRuns = 0;
+    int mergePasses = 0;
+    long long bytesWritten = 0;
+};
+
+// Внешняя сортировка слиянием. Sort читает вход кусками по бюджету памяти, сортирует
+// каждый кусок и сбрасывает его прогоном во временный файл в формате SequenceSerializer
+// (заголовок с контрольной суммой + элементы). Прогоны сливаются турниром с
+// проигравшими (loser tree) за log k сравнений на элемент; каждый прогон читается
+// двумя буферами — пока слияние разбирает один, фоновый поток читает в другой.
+// Если прогонов больше, чем позволяет бюджет на буферы, сначала выполняются
+// промежуточные проходы слияния. Вход, целиком помещающийся в бюджет, на диск не пишется.
+// Результат выдаётся потоково через перечислитель или в sink; сортировка не устойчива.
+template <typename T, typename Compare = std::less<T>>
+class ExternalSorter : public IEnumerable<T> {
+    static_assert(std::is_trivially_copyable<T>::value, "ExternalSorter spills elements as raw bytes");
+
+private:
+    static constexpr long long MinBlockBytes = 64 << 10;
+    static constexpr long long HeaderBytes = sizeof(SequenceFileHeader);
+
+    struct Run {
+        int fd = -1;
+        long long length = 0;
+        std::uint64_t checksum = 0;
+    };
+
+    // Последовательное чтение прогона с двойной буферизацией
+    class RunReader {
+    private:
+        const Run& run;
+        BackgroundFileIO& io;
+        DynamicArray<T> buffers[2];
+        std::future<void> pending;
+        int current;
+        int position;
+        int filled;
+        int pendingCount;
+        long long requested;
+        long long consumed;
+        SequenceChecksum checksum;
+
+        // Заказывает следующий блок в свободный буфер
+        void RequestNext() {
+            long long left = run.length - requested;
+            int blockSize = buffers[0].GetSize();
+            pendingCount = left < blockSize ? static_cast<int>(left) : blockSize;
+            if (pendingCount == 0) {
+                return;
+            }
+            pending = io.ReadAt(run.fd, buffers[1 - current].GetData(), sizeof(T) * static_cast<long long>(pendingCount),
+                                HeaderBytes + sizeof(T) * requested);
+            requested += pendingCount;
+        }
+
+        void SwapBuffers() {
+            pending.get();
+            current = 1 - current;
+            position = 0;
+            filled = pendingCount;
+            checksum.Update(buffers[current].GetData(), sizeof(T) * static_cast<std::size_t>(filled));
+            consumed += filled;
+            if (consumed == run.length && checksum.Finish() != run.checksum) {
+                throw SerializationException("Sort run checksum mismatch: temporary data is corrupted");
+            }
+            RequestNext();
+        }
+
+    public:
+        // Первый блок читается сразу, второй заказывается в фон
+        RunReader(const Run& run, BackgroundFileIO& io, int blockSize)
+            : run(run), io(io), current(1), position(0), filled(0), pendingCount(0), requested(0), consumed(0) {
+            int size = run.length < blockSize ? static_cast<int>(run.length) : blockSize;
+            buffers[0] = DynamicArray<T>(size > 0 ? size : 1);
+            buffers[1] = DynamicArray<T>(size > 0 ? size : 1);
+            RequestNext();
+            if (pendingCount > 0) {
+                SwapBuffers();
+            }
+        }
+
+        // Дожидается незавершённого чтения: буферы не должны исчезнуть под фоновым потоком
+        ~RunReader() {
+            if (pending.valid()) {
+                pending.wait();
+            }
+        }
+
+        bool IsExhausted() const {
+            return position == filled;
+        }
+
+        const T& Current() const {
+            return buffers[current][position];
+        }
+
+        void Advance() {
+            ++position;
+            if (position == filled && pendingCount > 0) {
+                SwapBuffers();
+            }
+        }
+    };
+
+    // Турнир с проигравшими: tree[0] — победитель, во внутренних узлах — проигравшие
+    class LoserTree {
+    private:
+        RunReader** sources;
+        int count;
+        DynamicArray<int> tree;
+        Compare compare;
+
+        // -1 — фиктивный участник, который побеждает всех, пока дерево строится
+        bool Beats(int a, int b) const {
+            if (a < 0 || b < 0) {
+                return a < 0;
+            }
+            if (sources[a]->IsExhausted() || sources[b]->IsExhausted()) {
+                return !sources[a]->IsExhausted();
+            }
+            if (compare(sources[a]->Current(), sources[b]->Current())) {
+                return true;
+            }
+            return !compare(sources[b]->Current(), sources[a]->Current()) && a < b;
+        }
+
+        void Adjust(int winner) {
+            for (int node = (winner + count) / 2; node > 0; node /= 2) {
+                if (Beats(tree[node], winner)) {
+                    std::swap(tree[node], winner);
+                }
+            }
+            tree[0] = winner;
+        }
+
+    public:
+        LoserTree(RunReader** sources, int count, Compare compare)
+            : sources(sources), count(count), tree(count), compare(compare) {
+            for (int i = 0; i < count; ++i) {
+                tree[i] = -1;
+            }
+            for (int i = count - 1; i >= 0; --i) {
+                Adjust(i);
+            }
+        }
+
+        bool IsExhausted() const {
+            return sources[tree[0]]->IsExhausted();
+        }
+
+        const T& Current() const {
+            return sources[tree[0]]->Current();
+        }
+
+        void Advance() {
+            int winner = tree[0];
+            sources[winner]->Advance();
+            Adjust(winner);
+        }
+    };
+
+    // Слияние группы прогонов; владеет читателями
+    class Merger {
+    private:
+        RunReader** readers;
+        int count;
+        LoserTree* tree;
+
+    public:
+        Merger(const Run* runs, int groupSize, BackgroundFileIO& io, int blockSize, Compare compare)
+            : readers(new RunReader*[groupSize]), count(0), tree(nullptr) {
+            try {
+                for (; count < groupSize; ++count) {
+                    readers[count] = new RunReader(runs[count], io, blockSize);
+                }
+                tree = new LoserTree(readers, count, compare);
+            } catch (...) {
+                Release();
+                throw;
+            }
+        }
+
+        Merger(const Merger&) = delete;
+        Merger& operator=(const Merger&) = delete;
+
+        ~Merger() {
+            Release();
+        }
+
+        void Release() {
+            delete tree;
+            tree = nullptr;
+            for (int i = 0; i < count; ++i) {
+                delete readers[i];
+            }
+            delete[] readers;
+            readers = nullptr;
+            count = 0;
+        }
+
+        bool IsExhausted() const {
+            return tree->IsExhausted();
+        }
+
+        const T& Current() const {
+            return tree->Current();
+        }
+
+        void Advance() {
+            tree->Advance();
+        }
+    };
+
+    // Запись прогона: пока один буфер пишется в фоне, заполняется другой.
+    // Заголовок с контрольной суммой пишется последним.
+    class RunWriter {
+    private:
+        Run& run;
+        BackgroundFileIO& io;
+        DynamicArray<T> buffers[2];
+        std::future<void> pending;
+        int current;
+        int filled;
+        SequenceChecksum checksum;
+
+        void FlushBuffer() {
+            if (filled == 0) {
+                return;
+            }
+            checksum.Update(buffers[current].GetData(), sizeof(T) * static_cast<std::size_t>(filled));
+            if (pending.valid()) {
+                pending.get();
+            }
+            pending = io.WriteAt(run.fd, buffers[current].GetData(), sizeof(T) * static_cast<long long>(filled),
+                                 HeaderBytes + sizeof(T) * run.length);
+            run.length += filled;
+            current = 1 - current;
+            filled = 0;
+        }
+
+    public:
+        RunWriter(Run& run, BackgroundFileIO& io, int blockSize) : run(run), io(io), current(0), filled(0) {
+            buffers[0] = DynamicArray<T>(blockSize);
+            buffers[1] = DynamicArray<T>(blockSize);
+        }
+
+        ~RunWriter() {
+            if (pending.valid()) {
+                pending.wait();
+            }
+        }
+
+        void Push(const T& item) {
+            buffers[current][filled++] = item;
+            if (filled == buffers[current].GetSize()) {
+                FlushBuffer();
+            }
+        }
+
+        void Finish() {
+            FlushBuffer();
+            if (pending.valid()) {
+                pending.get();
+            }
+            run.checksum = checksum.Finish();
+            WriteRunHeader(run);
+        }
+    };
+
+    class MergeEnumerator : public IEnumerator<T> {
+    private:
+        const ExternalSorter& sorter;
+        Merger* merger;
+        int memoryIndex;
+        bool started;
+
+    public:
+        explicit MergeEnumerator(const ExternalSorter& sorter)
+            : sorter(sorter), merger(nullptr), memoryIndex(-1), started(false) {}
+
+        ~MergeEnumerator() override {
+            delete merger;
+        }
+
+        bool MoveNext() override {
+            if (sorter.runCount == 0) {
+                ++memoryIndex;
+                return memoryIndex < sorter.memoryRun.GetSize();
+            }
+            if (!started) {
+                merger = new Merger(sorter.runs, sorter.runCount, *sorter.io, sorter.GetBlockSize(sorter.runCount, false),
+                                    sorter.compare);
+                started = true;
+            } else if (!merger->IsExhausted()) {
+                merger->Advance();
+            }
+            return !merger->IsExhausted();
+        }
+
+        const T& Current() const override {
+            if (sorter.runCount == 0) {
+                if (memoryIndex < 0 || memoryIndex >= sorter.memoryRun.GetSize()) {
+                    throw InvalidStateException("Enumerator is not in a valid position");
+                }
+                return sorter.memoryRun[memoryIndex];
+            }
+            if (!started || merger->IsExhausted()) {
+                throw InvalidStateException("Enumerator is not in a valid position");
+            }
+            return merger->Current();
+        }
+
+        void Reset() override {
+            delete merger;
+            merger = nullptr;
+            started = false;
+            memoryIndex = -1;
+        }
+    };
+
+    long long memoryBudget;
+    std::string directory;
+    Compare compare;
+
+    // Фоновый поток создаётся один раз и переживает перечислители
+    BackgroundFileIO* io;
+    Run* runs;
+    int runCount;
+    DynamicArray<T> memoryRun;
+    ExternalSortStats stats;
+
+    static void WriteRunHeader(const Run& run) {
+        SequenceFileHeader header;
+        std::memcpy(header.magic, "SEQB", 4);
+        header.version = SequenceFileHeader::CurrentVersion;
+        header.flags = SequenceFileHeader::RawPayload;
+        header.typeTag = SequenceCodec<T>::TypeTag;
+        header.elementSize = static_cast<std::uint32_t>(sizeof(T));
+        header.length = run.length;
+        header.checksum = run.checksum;
+        WriteFileAt(run.fd, &header, HeaderBytes, 0);
+    }
+
+    // Максимум прогонов в одном слиянии: у каждого два буфера не меньше MinBlockBytes,
+    // плюс два буфера записи при промежуточном проходе
+    int GetMaxFanIn() const {
+        long long fanIn = memoryBudget / (2 * MinBlockBytes) - 1;
+        return fanIn < 2 ? 2 : (fanIn > (1 << 16) ? (1 << 16) : static_cast<int>(fanIn));
+    }
+
+    int GetBlockSize(int fanIn, bool withWriter) const {
+        long long buffers = 2LL * fanIn + (withWriter ? 2 : 0);
+        long long elements = memoryBudget / buffers / static_cast<long long>(sizeof(T));
+        long long minimum = MinBlockBytes / static_cast<long long>(sizeof(T));
+        if (elements < minimum) {
+            elements = minimum > 0 ? minimum : 1;
+        }
+        return elements > (1 << 24) ? (1 << 24) : static_cast<int>(elements);
+    }
+
+    void ReleaseRuns() {
+        for (int i = 0; i < runCount; ++i) {
+            close(runs[i].fd);
+        }
+        delete[] runs;
+        runs = nullptr;
+        runCount = 0;
+    }
+
+    void AddRun(const Run& run) {
+        Run* grown = new Run[runCount + 1];
+        std::copy(runs, runs + runCount, grown);
+        grown[runCount] = run;
+        delete[] runs;
+        runs = grown;
+        ++runCount;
+    }
+
+    void SpillRun(const T* items, int count) {
+        Run run;
+        run.fd = CreateUnlinkedTempFile(directory, "sequence-sort");
+        run.length = count;
+        SequenceChecksum checksum;
+        checksum.Update(items, sizeof(T) * static_cast<std::size_t>(count));
+        run.checksum = checksum.Finish();
+        try {
+            WriteFileAt(run.fd, items, sizeof(T) * static_cast<long long>(count), HeaderBytes);
+            WriteRunHeader(run);
+        } catch (...) {
+            close(run.fd);
+            throw;
+        }
+        AddRun(run);
+        stats.bytesWritten += HeaderBytes + sizeof(T) * static_cast<long long>(count);
+    }
+
+    // Промежуточные проходы: сливает группы по fanIn прогонов, пока их не станет не больше fanIn
+    void ReduceRuns() {
+        int fanIn = GetMaxFanIn();
+        while (runCount > fanIn) {
+            int blockSize = GetBlockSize(fanIn, true);
+            Run* previous = runs;
+            int previousCount = runCount;
+            runs = nullptr;
+            runCount = 0;
+            try {
+                for (int first = 0; first < previousCount; first += fanIn) {
+                    int groupSize = previousCount - first < fanIn ? previousCount - first : fanIn;
+                    Run merged;
+                    merged.fd = CreateUnlinkedTempFile(directory, "sequence-sort");
+                    try {
+                        Merger merger(previous + first, groupSize, *io, blockSize, compare);
+                        RunWriter writer(merged, *io, blockSize);
+                        for (; !merger.IsExhausted(); merger.Advance()) {
+                            writer.Push(merger.Current());
+                        }
+                        writer.Finish();
+                    } catch (...) {
+                        close(merged.fd);
+                        throw;
+                    }
+                    AddRun(merged);
+                    stats.bytesWritten += HeaderBytes + sizeof(T) * merged.length;
+                }
+            } catch (...) {
+                for (int i = 0; i < previousCount; ++i) {
+                    close(previous[i].fd);
+                }
+                delete[] previous;
+                throw;
+            }
+            for (int i = 0; i < previousCount; ++i) {
+                close(previous[i].fd);
+            }
+            delete[] previous;
+            ++stats.mergePasses;
+        }
+    }
+
+public:
+    // memoryBudget — байт под элементы при формировании прогонов и под буферы слияния
+    explicit ExternalSorter(long long memoryBudget = 64LL << 20, const std::string& directory = "",
+                            Compare compare = Compare())
+        : memoryBudget(memoryBudget), directory(directory), compare(compare), io(nullptr), runs(nullptr),
+          runCount(0) {
+        if (memoryBudget < static_cast<long long>(sizeof(T))) {
+            throw InvalidArgumentException("Memory budget must hold at least one element");
+        }
+        io = new BackgroundFileIO();
+    }
+
+    ExternalSorter(const ExternalSorter&) = delete;
+    ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+    ~ExternalSorter() override {
+        ReleaseRuns();
+        delete io;
+    }
+
+    // Сортирует input; результат предыдущего вызова отбрасывается.
+    // Перечислители, полученные до вызова, становятся недействительными.
+    void Sort(const Sequence<T>& input) {
+        ReleaseRuns();
+        memoryRun = DynamicArray<T>();
+        stats = ExternalSortStats();
+
+        long long capacity = memoryBudget / static_cast<long long>(sizeof(T));
+        int runCapacity = capacity > (1 << 30) ? (1 << 30) : static_cast<int>(capacity);
+        int length = input.GetLength();
+        DynamicArray<T> buffer(length < runCapacity ? length : runCapacity);
+        int filled = 0;
+        IEnumerator<T>* enumerator = input.GetEnumerator();
+        try {
+            while (enumerator->MoveNext()) {
+                if (filled == buffer.GetSize()) {
+                    std::sort(buffer.GetData(), buffer.GetData() + filled, compare);
+                    SpillRun(buffer.GetData(), filled);
+                    filled = 0;
+                }
+                buffer[filled++] = enumerator->Current();
+            }
+        } catch (...) {
+            delete enumerator;
+            throw;
+        }
+        delete enumerator;
+
+        std::sort(buffer.GetData(), buffer.GetData() + filled, compare);
+        if (runCount == 0) {
+            buffer.Resize(filled);
+            memoryRun = std::move(buffer);
+            return;
+        }
+        SpillRun(buffer.GetData(), filled);
+        stats.initialRuns = runCount;
+        // Буфер прогонов больше не нужен: бюджет переходит буферам слияния
+        buffer = DynamicArray<T>();
+        ReduceRuns();
+    }
+
+    // Последнее слияние идёт на лету, по мере перечисления
+    IEnumerator<T>* GetEnumerator() const override {
+        SEQUENCE_COUNT(EnumeratorAllocations, 1);
+        return new MergeEnumerator(*this);
+    }
+
+    void MergeInto(ISequenceSink<T>& sink) const {
+        IEnumerator<T>* enumerator = GetEnumerator();
+        try {
+            while (enumerator->MoveNext()) {
+                sink.Push(enumerator->Current());
+            }
+        } catch (...) {
+            delete enumerator;
+            throw;
+        }
+        delete enumerator;
+    }
+
+    ArraySequence<T>* ToArraySequence() const {
+        DynamicArray<T> items;
+        DynamicArraySink<T> sink(items);
+        MergeInto(sink);
+        return new ArraySequence<T>(std::move(items));
+    }
+
+    // Результат тоже может не помещаться в память
+    SpillableSequence<T>* ToSpillableSequence(long long outputBudget, int pageSize = 1 << 16) const {
+        SpillableSequence<T>* result = new SpillableSequence<T>(outputBudget, pageSize, directory);
+        IEnumerator<T>* enumerator = GetEnumerator();
+        try {
+            while (enumerator->MoveNext()) {
+                result->Append(enumerator->Current());
+            }
+        } catch (...) {
+            delete enumerator;
+            delete result;
+            throw;
+        }
+        delete enumerator;
+        return result;
+    }
+
+    const ExternalSortStats& GetStats() const {
+        return stats;
+    }
+};
@@ -0,0 +1,156 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "DynamicArray.hpp"
+
+// Индекс значений массива: для каждого значения — первая позиция и число вхождений.
+// Последовательность сообщает о вставках и перестановках, индекс обновляется сам.
+template <typename T>
+class ISequenceIndex {
+public:
+    virtual ~ISequenceIndex() = default;
+
+    // Элемент item вставлен на позицию position; длина массива стала newLength
+    virtual void OnInsert(const T& item, int position, int newLength) = 0;
+    // Полное перестроение после перестановок элементов
+    virtual void Rebuild(const T* items, int length) = 0;
+    virtual int IndexOf(const T& item) const = 0;
+    virtual int CountOf(const T& item) const = 0;
+    virtual long long GetMemoryBytes() const = 0;
+    virtual ISequenceIndex<T>* Clone() const = 0;
+    // Пустой индекс того же вида — для новых последовательностей
+    virtual ISequenceIndex<T>* CreateEmpty() const = 0;
+};
+
+// Открытая адресация с линейным пробированием: ключ, позиция и счётчик лежат в
+// одной ячейке, поиск обычно укладывается в одну строку кэша. Заполнение не выше
+// половины. Хеш дополнительно перемешивается — std::hash для целых тождественный,
+// и без этого последовательные значения образуют длинные кластеры.
+template <typename T, typename Hash = std::hash<T>>
+class HashIndex : public ISequenceIndex<T> {
+private:
+    static constexpr int MinCapacity = 16;
+
+    // Позиция хранится со сдвигом на единицу: ноль — пустая ячейка, поэтому
+    // свежевыделенная таблица уже пуста
+    struct Slot {
+        T key;
+        int positionPlusOne;
+        int count;
+    };
+
+    DynamicArray<Slot> slots;
+    int used;
+    Hash hash;
+
+    static std::uint64_t Mix(std::uint64_t value) {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    int FindSlot(const T& key) const {
+        const Slot* data = slots.GetData();
+        int mask = slots.GetSize() - 1;
+        int slot = static_cast<int>(Mix(static_cast<std::uint64_t>(hash(key))) & static_cast<std::uint64_t>(mask));
+        while (data[slot].positionPlusOne != 0 && !(data[slot].key == key)) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void Allocate(int capacity) {
+        slots = DynamicArray<Slot>(capacity);
+        used = 0;
+    }
+
+    void Grow() {
+        DynamicArray<Slot> old(std::move(slots));
+        Allocate(old.GetSize() * 2);
+        Slot* data = slots.GetData();
+        for (int i = 0; i < old.GetSize(); ++i) {
+            if (old[i].positionPlusOne != 0) {
+                data[FindSlot(old[i].key)] = std::move(old[i]);
+                used++;
+            }
+        }
+    }
+
+    // Новое вхождение; первую позицию уже известного значения не меняет
+    void AddOccurrence(const T& item, int position) {
+        if (2 * (used + 1) > slots.GetSize()) {
+            Grow();
+        }
+        Slot& slot = slots.GetData()[FindSlot(item)];
+        if (slot.positionPlusOne == 0) {
+            slot.key = item;
+            slot.positionPlusOne = position + 1;
+            slot.count = 1;
+            used++;
+        } else {
+            slot.count++;
+        }
+    }
+
+public:
+    explicit HashIndex(Hash hash = Hash()) : used(0), hash(hash) {
+        Allocate(MinCapacity);
+    }
+
+    void OnInsert(const T& item, int position, int newLength) override {
+        Slot* data = slots.GetData();
+        // Вставка не в конец сдвигает позиции всех значений правее
+        if (position < newLength - 1) {
+            for (int i = 0; i < slots.GetSize(); ++i) {
+                if (data[i].positionPlusOne > position) {
+                    data[i].positionPlusOne++;
+                }
+            }
+        }
+        AddOccurrence(item, position);
+        Slot& slot = slots.GetData()[FindSlot(item)];
+        if (slot.positionPlusOne > position + 1) {
+            slot.positionPlusOne = position + 1;
+        }
+    }
+
+    void Rebuild(const T* items, int length) override {
+        int capacity = MinCapacity;
+        while (capacity < 2 * length) {
+            capacity *= 2;
+        }
+        Allocate(capacity);
+        for (int i = 0; i < length; ++i) {
+            AddOccurrence(items[i], i);
+        }
+    }
+
+    int IndexOf(const T& item) const override {
+        return slots.GetData()[FindSlot(item)].positionPlusOne - 1;
+    }
+
+    int CountOf(const T& item) const override {
+        const Slot& slot = slots.GetData()[FindSlot(item)];
+        return slot.positionPlusOne != 0 ? slot.count : 0;
+    }
+
+    int GetDistinctCount() const {
+        return used;
+    }
+
+    long long GetMemoryBytes() const override {
+        return static_cast<long long>(sizeof(Slot)) * slots.GetCapacity();
+    }
+
+    ISequenceIndex<T>* Clone() const override {
+        return new HashIndex<T, Hash>(*this);
+    }
+
+    ISequenceIndex<T>* CreateEmpty() const override {
+        return new HashIndex<T, Hash>(hash);
+    }
+};
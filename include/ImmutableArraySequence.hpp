@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <utility>
 #include "Sequence.hpp"
 #include "DynamicArray.hpp"
@@ -9,10 +10,20 @@ class ImmutableArraySequence : public ArraySequence<T> {
 private:
     using ArraySequence<T>::array;
 
+protected:
+    void CheckMutable() const override {
+        throw InvalidOperationException("Cannot modify immutable sequence");
+    }
+
+    const char* GetTraceName() const override {
+        return "ImmutableArraySequence";
+    }
+
 public:
     ImmutableArraySequence() = default;
     ImmutableArraySequence(const T* items, int count) : ArraySequence<T>(items, count) {}
     ImmutableArraySequence(const DynamicArray<T>& other) : ArraySequence<T>(other) {}
+    ImmutableArraySequence(DynamicArray<T>&& other) : ArraySequence<T>(std::move(other)) {}
     ImmutableArraySequence(const ArraySequence<T>& other) : ArraySequence<T>(other) {}
     ImmutableArraySequence(const ImmutableArraySequence<T>& other) : ArraySequence<T>(other) {}
 
@@ -32,125 +43,107 @@ public:
         ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>(*this);
         result->array.Resize(array.GetSize() + 1);
         result->array.Set(array.GetSize(), item);
+        result->NotifyInserted(item, array.GetSize());
         return result;
     }
 
     ImmutableArraySequence<T>* PrependNew(const T& item) const {
-        ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
-        result->array.Resize(array.GetSize() + 1);
-        result->array.Set(0, item);
-        for (int i = 0; i < array.GetSize(); ++i) {
-            result->array.Set(i + 1, array.Get(i));
-        }
-        return result;
+        return InsertAtNew(item, 0);
     }
 
     ImmutableArraySequence<T>* InsertAtNew(const T& item, int index) const {
         if (index < 0 || index > array.GetSize()) {
             throw IndexOutOfRangeException("Invalid insert index");
         }
-        ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
-        result->array.Resize(array.GetSize() + 1);
-        
-        for (int i = 0; i < index; ++i) {
-            result->array.Set(i, array.Get(i));
-        }
-        result->array.Set(index, item);
-        for (int i = index; i < array.GetSize(); ++i) {
-            result->array.Set(i + 1, array.Get(i));
+        DynamicArray<T> items(array.GetSize() + 1);
+        const T* source = array.GetData();
+        T* target = items.GetData();
+        std::copy(source, source + index, target);
+        target[index] = item;
+        std::copy(source + index, source + array.GetSize(), target + index + 1);
+
+        ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>(std::move(items));
+        // Копия индекса сдвигается одной вставкой — значения заново не хешируются
+        if (this->valueIndex != nullptr) {
+            result->valueIndex = this->valueIndex->Clone();
+            result->NotifyInserted(item, index);
         }
         return result;
     }
 
     Sequence<T>* Map(T (*func)(const T&)) const override {
-        ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
-        for (int i = 0; i < array.GetSize(); ++i) {
-            result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(func(array.Get(i))));
-        }
-        return result;
+        SEQUENCE_TRACE_SCOPE("Map", this->GetTraceName());
+        DynamicArray<T> result;
+        this->MapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableArraySequence<T>(std::move(result));
     }
 
     Sequence<T>* Where(bool (*predicate)(const T&)) const override {
-        ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
-        for (int i = 0; i < array.GetSize(); ++i) {
-            T current = array.Get(i);
-            if (predicate(current)) {
-                result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(current));
-            }
-        }
-        return result;
+        SEQUENCE_TRACE_SCOPE("Where", this->GetTraceName());
+        DynamicArray<T> result;
+        this->WhereInto(predicate, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableArraySequence<T>(std::move(result));
     }
 
-    Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const override {
-        int length = array.GetSize();
+    Sequence<T>* Where(const BitSequence& mask) const {
+        SEQUENCE_TRACE_SCOPE("WhereMask", this->GetTraceName());
+        DynamicArray<T> result;
+        this->WhereInto(mask, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableArraySequence<T>(std::move(result));
+    }
 
-        if (i < 0) {
-            i = length + i;
-        }
-        if (i < 0 || i >= length) {
-            throw IndexOutOfRangeException("Invalid slice index");
-        }
-        if (i + N > length) {
-            N = length - i;
-        }
-        
-        ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
-        
-        for (int j = 0; j < i; ++j) {
-            result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(array.Get(j)));
-        }
-        
-        if (s != nullptr) {
-            for (int j = 0; j < s->GetLength(); ++j) {
-                result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(s->Get(j)));
-            }
-        }
-        
-        for (int j = i + N; j < length; ++j) {
-            result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(array.Get(j)));
-        }
-        
-        return result;
+    Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const override {
+        SEQUENCE_TRACE_SCOPE("Slice", this->GetTraceName());
+        DynamicArray<T> result;
+        this->SliceInto(i, N, s, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        ImmutableArraySequence<T>* sliced = new ImmutableArraySequence<T>(std::move(result));
+        sliced->InheritIndex(*this);
+        return sliced;
     }
 
     Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const override {
-        ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
-        for (int i = 0; i < array.GetSize(); ++i) {
-            Sequence<T>* subseq = func(array.Get(i));
-            for (int j = 0; j < subseq->GetLength(); ++j) {
-                result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(subseq->Get(j)));
-            }
-            delete subseq;
-        }
-        return result;
+        SEQUENCE_TRACE_SCOPE("FlatMap", this->GetTraceName());
+        DynamicArray<T> result;
+        this->FlatMapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableArraySequence<T>(std::move(result));
+    }
+
+    Sequence<T>* FlatMap(void (*func)(const T&, ISequenceSink<T>&)) const override {
+        SEQUENCE_TRACE_SCOPE("FlatMap", this->GetTraceName());
+        DynamicArray<T> result;
+        this->FlatMapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableArraySequence<T>(std::move(result));
+    }
+
+    Sequence<T>* ParallelFlatMap(void (*func)(const T&, ISequenceSink<T>&)) const {
+        SEQUENCE_TRACE_SCOPE("ParallelFlatMap", this->GetTraceName());
+        DynamicArray<T> result;
+        this->ParallelFlatMapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableArraySequence<T>(std::move(result));
     }
 
     std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const override {
-        auto* trueSeq = new ImmutableArraySequence<T>();
-        auto* falseSeq = new ImmutableArraySequence<T>();
-        
-        for (int i = 0; i < array.GetSize(); i++) {
-            if (predicate(array.Get(i))) {
-                trueSeq = static_cast<ImmutableArraySequence<T>*>(trueSeq->AppendNew(array.Get(i)));
-            } else {
-                falseSeq = static_cast<ImmutableArraySequence<T>*>(falseSeq->AppendNew(array.Get(i)));
-            }
-        }
-        return std::make_pair(trueSeq, falseSeq);
+        SEQUENCE_TRACE_SCOPE("Split", this->GetTraceName());
+        DynamicArray<T> matching;
+        DynamicArray<T> notMatching;
+        this->PartitionInto(predicate, matching, notMatching);
+        SEQUENCE_TRACE_OUTPUT(matching.GetSize() + notMatching.GetSize());
+        return std::make_pair(new ImmutableArraySequence<T>(std::move(matching)),
+                              new ImmutableArraySequence<T>(std::move(notMatching)));
     }
 
     Sequence<T>* Concat(const Sequence<T>* other) const override {
-        ImmutableArraySequence<T>* result = new ImmutableArraySequence<T>();
-        
-        for (int i = 0; i < array.GetSize(); ++i) {
-            result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(array.Get(i)));
-        }
-    
-        for (int i = 0; i < other->GetLength(); ++i) {
-            result = static_cast<ImmutableArraySequence<T>*>(result->AppendNew(other->Get(i)));
-        }
-        
-        return result;
+        SEQUENCE_TRACE_SCOPE("Concat", this->GetTraceName());
+        DynamicArray<T> result;
+        this->ConcatInto(other, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableArraySequence<T>(std::move(result));
     }
 };
-
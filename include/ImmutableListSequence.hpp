@@ -9,10 +9,16 @@ class ImmutableListSequence : public ListSequence<T> {
 private:
     using ListSequence<T>::list;
 
+protected:
+    const char* GetTraceName() const override {
+        return "ImmutableListSequence";
+    }
+
 public:
     ImmutableListSequence() = default;
     ImmutableListSequence(const T* items, int count) : ListSequence<T>(items, count) {}
     ImmutableListSequence(const LinkedList<T>& other) : ListSequence<T>(other) {}
+    ImmutableListSequence(LinkedList<T>&& other) : ListSequence<T>(std::move(other)) {}
     ImmutableListSequence(const ListSequence<T>& other) : ListSequence<T>(other) {}
     ImmutableListSequence(const ImmutableListSequence<T>& other) : ListSequence<T>(other) {}
 
@@ -50,95 +56,60 @@ public:
     }
 
     Sequence<T>* Map(T (*func)(const T&)) const override {
-        ImmutableListSequence<T>* result = new ImmutableListSequence<T>();
-        for (int i = 0; i < list.GetSize(); ++i) {
-            result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(func(list.Get(i))));
-        }
-        return result;
+        SEQUENCE_TRACE_SCOPE("Map", this->GetTraceName());
+        LinkedList<T> result;
+        this->MapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableListSequence<T>(std::move(result));
     }
 
     Sequence<T>* Where(bool (*predicate)(const T&)) const override {
-        ImmutableListSequence<T>* result = new ImmutableListSequence<T>();
-        for (int i = 0; i < list.GetSize(); ++i) {
-            T current = list.Get(i);
-            if (predicate(current)) {
-                result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(current));
-            }
-        }
-        return result;
+        SEQUENCE_TRACE_SCOPE("Where", this->GetTraceName());
+        LinkedList<T> result;
+        this->WhereInto(predicate, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableListSequence<T>(std::move(result));
     }
 
     Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const override {
-        int length = list.GetSize();
-        
-        if (i < 0) {
-            i = length + i;
-        }
-        if (i < 0 || i >= length) {
-            throw IndexOutOfRangeException("Invalid slice index");
-        }
-        if (i + N > length) {
-            N = length - i;
-        }
-        
-        ImmutableListSequence<T>* result = new ImmutableListSequence<T>();
-        
-        for (int j = 0; j < i; ++j) {
-            result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(list.Get(j)));
-        }
-        
-        if (s != nullptr) {
-            for (int j = 0; j < s->GetLength(); ++j) {
-                result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(s->Get(j)));
-            }
-        }
-
-        for (int j = i + N; j < length; ++j) {
-            result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(list.Get(j)));
-        }
-        
-        return result;
+        SEQUENCE_TRACE_SCOPE("Slice", this->GetTraceName());
+        LinkedList<T> result;
+        this->SliceInto(i, N, s, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableListSequence<T>(std::move(result));
     }
 
     Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const override {
-        ImmutableListSequence<T>* result = new ImmutableListSequence<T>();
-        for (int i = 0; i < list.GetSize(); ++i) {
-            Sequence<T>* subseq = func(list.Get(i));
-            for (int j = 0; j < subseq->GetLength(); ++j) {
-                result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(subseq->Get(j)));
-            }
-            delete subseq;
-        }
-        return result;
+        SEQUENCE_TRACE_SCOPE("FlatMap", this->GetTraceName());
+        LinkedList<T> result;
+        this->FlatMapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableListSequence<T>(std::move(result));
     }
 
-    std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const override {
-        ImmutableListSequence<T>* matching = new ImmutableListSequence<T>();
-        ImmutableListSequence<T>* notMatching = new ImmutableListSequence<T>();
-
-        for (int i = 0; i < list.GetSize(); ++i) {
-            T current = list.Get(i);
-            if (predicate(current)) {
-                matching = static_cast<ImmutableListSequence<T>*>(matching->AppendNew(current));
-            } else {
-                notMatching = static_cast<ImmutableListSequence<T>*>(notMatching->AppendNew(current));
-            }
-        }
+    Sequence<T>* FlatMap(void (*func)(const T&, ISequenceSink<T>&)) const override {
+        SEQUENCE_TRACE_SCOPE("FlatMap", this->GetTraceName());
+        LinkedList<T> result;
+        this->FlatMapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableListSequence<T>(std::move(result));
+    }
 
-        return std::make_pair(matching, notMatching);
+    std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("Split", this->GetTraceName());
+        LinkedList<T> matching;
+        LinkedList<T> notMatching;
+        this->SplitInto(predicate, matching, notMatching);
+        SEQUENCE_TRACE_OUTPUT(matching.GetSize() + notMatching.GetSize());
+        return std::make_pair(new ImmutableListSequence<T>(std::move(matching)),
+                              new ImmutableListSequence<T>(std::move(notMatching)));
     }
 
     Sequence<T>* Concat(const Sequence<T>* other) const override {
-        ImmutableListSequence<T>* result = new ImmutableListSequence<T>();
-        
-        for (int i = 0; i < list.GetSize(); ++i) {
-            result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(list.Get(i)));
-        }
-        
-        for (int i = 0; i < other->GetLength(); ++i) {
-            result = static_cast<ImmutableListSequence<T>*>(result->AppendNew(other->Get(i)));
-        }
-        
-        return result;
+        SEQUENCE_TRACE_SCOPE("Concat", this->GetTraceName());
+        LinkedList<T> result;
+        this->ConcatInto(other, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ImmutableListSequence<T>(std::move(result));
     }
 };
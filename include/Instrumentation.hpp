@@ -0,0 +1,146 @@
+#pragma once
+
+// Счётчики горячих путей. Включаются опцией CMake SEQUENCE_INSTRUMENTATION;
+// без неё макросы раскрываются в пустое выражение и аргументы не вычисляются.
+//
+//   SEQUENCE_COUNT(ArrayResizeCalls, 1);
+//   InstrumentationSnapshot snapshot = Instrumentation::Snapshot();
+//   Instrumentation::Report(std::cout);
+
+#ifdef SEQUENCE_INSTRUMENTATION
+
+#include <atomic>
+#include <mutex>
+#include <ostream>
+
+enum class InstrumentationCounter {
+    ArrayResizeCalls,
+    ArrayReallocations,
+    BytesCopied,
+    ListGetWalks,
+    ListGetSteps,
+    ListInsertSteps,
+    EnumeratorAllocations,
+    Count
+};
+
+struct InstrumentationSnapshot {
+    long long values[static_cast<int>(InstrumentationCounter::Count)] = {};
+
+    long long Get(InstrumentationCounter counter) const {
+        return values[static_cast<int>(counter)];
+    }
+
+    // Разница двух снимков — сколько насчитано между ними
+    InstrumentationSnapshot operator-(const InstrumentationSnapshot& other) const {
+        InstrumentationSnapshot result;
+        for (int i = 0; i < static_cast<int>(InstrumentationCounter::Count); ++i) {
+            result.values[i] = values[i] - other.values[i];
+        }
+        return result;
+    }
+};
+
+// Каждый поток пишет в свой блок счётчиков без блокировок; Snapshot() суммирует
+// блоки живых потоков и итоги уже завершившихся.
+class Instrumentation {
+private:
+    static const int CounterCount = static_cast<int>(InstrumentationCounter::Count);
+
+    struct ThreadCounters;
+
+    struct Registry {
+        std::mutex mutex;
+        ThreadCounters* head = nullptr;
+        long long retired[CounterCount] = {};
+    };
+
+    struct ThreadCounters {
+        // Пишет только поток-владелец, атомарность нужна лишь для чтения из Snapshot()
+        std::atomic<long long> values[CounterCount];
+        ThreadCounters* next;
+
+        ThreadCounters() {
+            for (int i = 0; i < CounterCount; ++i) {
+                values[i].store(0, std::memory_order_relaxed);
+            }
+            Registry& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            next = registry.head;
+            registry.head = this;
+        }
+
+        ~ThreadCounters() {
+            Registry& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            for (int i = 0; i < CounterCount; ++i) {
+                registry.retired[i] += values[i].load(std::memory_order_relaxed);
+            }
+            ThreadCounters** link = &registry.head;
+            while (*link != this) {
+                link = &(*link)->next;
+            }
+            *link = next;
+        }
+    };
+
+    static Registry& GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    static ThreadCounters& Local() {
+        static thread_local ThreadCounters counters;
+        return counters;
+    }
+
+public:
+    static void Add(InstrumentationCounter counter, long long amount) {
+        std::atomic<long long>& value = Local().values[static_cast<int>(counter)];
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static InstrumentationSnapshot Snapshot() {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        InstrumentationSnapshot snapshot;
+        for (int i = 0; i < CounterCount; ++i) {
+            snapshot.values[i] = registry.retired[i];
+        }
+        for (ThreadCounters* counters = registry.head; counters; counters = counters->next) {
+            for (int i = 0; i < CounterCount; ++i) {
+                snapshot.values[i] += counters->values[i].load(std::memory_order_relaxed);
+            }
+        }
+        return snapshot;
+    }
+
+    static const char* GetName(InstrumentationCounter counter) {
+        switch (counter) {
+            case InstrumentationCounter::ArrayResizeCalls: return "DynamicArray::Resize calls";
+            case InstrumentationCounter::ArrayReallocations: return "DynamicArray reallocations";
+            case InstrumentationCounter::BytesCopied: return "Bytes copied";
+            case InstrumentationCounter::ListGetWalks: return "LinkedList::Get walks";
+            case InstrumentationCounter::ListGetSteps: return "LinkedList::Get steps";
+            case InstrumentationCounter::ListInsertSteps: return "LinkedList::InsertAt steps";
+            case InstrumentationCounter::EnumeratorAllocations: return "Enumerator allocations";
+            default: return "Unknown";
+        }
+    }
+
+    static void Report(std::ostream& out) {
+        InstrumentationSnapshot snapshot = Snapshot();
+        for (int i = 0; i < CounterCount; ++i) {
+            out << GetName(static_cast<InstrumentationCounter>(i)) << ": " << snapshot.values[i] << "\n";
+        }
+    }
+};
+
+#define SEQUENCE_COUNT(counter, amount) \
+    Instrumentation::Add(InstrumentationCounter::counter, static_cast<long long>(amount))
+
+#else
+
+#define SEQUENCE_COUNT(counter, amount) ((void)0)
+
+#endif
@@ -1,5 +1,7 @@
 #pragma once
 #include "Exceptions.hpp"
+#include "Instrumentation.hpp"
+#include "MemoryTracker.hpp"
 
 template <typename T>
 struct Node {
@@ -12,11 +14,24 @@ template <typename T>
 class LinkedList {
 private:
     Node<T>* head;
+    Node<T>* tail;
     int size;
 
+    // Узлы создаются и удаляются только здесь, чтобы учитываться в MemoryTracker
+    static Node<T>* CreateNode(const T& item) {
+        Node<T>* node = new Node<T>(item);
+        MemoryTracker::OnAllocate(sizeof(Node<T>));
+        return node;
+    }
+
+    static void DestroyNode(Node<T>* node) {
+        delete node;
+        MemoryTracker::OnFree(sizeof(Node<T>));
+    }
+
 public:
-    LinkedList() : head(nullptr), size(0) {}
-    LinkedList(const T* items, int count) : head(nullptr), size(0) {
+    LinkedList() : head(nullptr), tail(nullptr), size(0) {}
+    LinkedList(const T* items, int count) : head(nullptr), tail(nullptr), size(0) {
         if (count < 0) {
             throw InvalidSizeException("Count cannot be negative");
         }
@@ -25,7 +40,7 @@ public:
         }
     }
     // from
-    LinkedList(const LinkedList<T>& other) : head(nullptr), size(0) {
+    LinkedList(const LinkedList<T>& other) : head(nullptr), tail(nullptr), size(0) {
         Node<T>* current = other.head;
         while (current) {
             Append(current->data);
@@ -45,6 +60,25 @@ public:
         return *this;
     }
 
+    LinkedList(LinkedList<T>&& other) noexcept : head(other.head), tail(other.tail), size(other.size) {
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.size = 0;
+    }
+
+    LinkedList& operator=(LinkedList<T>&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            head = other.head;
+            tail = other.tail;
+            size = other.size;
+            other.head = nullptr;
+            other.tail = nullptr;
+            other.size = 0;
+        }
+        return *this;
+    }
+
     ~LinkedList() {
         Clear();
     }
@@ -53,6 +87,8 @@ public:
         if (index < 0 || index >= size) {
             throw IndexOutOfRangeException("Index out of range");
         }
+        SEQUENCE_COUNT(ListGetWalks, 1);
+        SEQUENCE_COUNT(ListGetSteps, index);
         Node<T>* current = head;
         for (int i = 0; i < index; ++i) {
             current = current->next;
@@ -71,35 +107,35 @@ public:
         if (size == 0) {
             throw EmptySequenceException();
         }
-        Node<T>* current = head;
-        while (current->next) {
-            current = current->next;
-        }
-        return current->data;
+        return tail->data;
     }
 
     int GetSize() const {
         return size;
     }
 
+    const Node<T>* GetHead() const {
+        return head;
+    }
+
     void Append(const T& item) {
-        Node<T>* newNode = new Node<T>(item);
+        Node<T>* newNode = CreateNode(item);
         if (!head) {
             head = newNode;
         } else {
-            Node<T>* current = head;
-            while (current->next) {
-                current = current->next;
-            }
-            current->next = newNode;
+            tail->next = newNode;
         }
+        tail = newNode;
         ++size;
     }
 
     void Prepend(const T& item) {
-        Node<T>* newNode = new Node<T>(item);
+        Node<T>* newNode = CreateNode(item);
         newNode->next = head;
         head = newNode;
+        if (!tail) {
+            tail = newNode;
+        }
         ++size;
     }
 
@@ -111,7 +147,12 @@ public:
             Prepend(item);
             return;
         }
-        Node<T>* newNode = new Node<T>(item);
+        if (index == size) {
+            Append(item);
+            return;
+        }
+        SEQUENCE_COUNT(ListInsertSteps, index - 1);
+        Node<T>* newNode = CreateNode(item);
         Node<T>* current = head;
         for (int i = 0; i < index - 1; ++i) {
             current = current->next;
@@ -125,8 +166,9 @@ public:
         while (head) {
             Node<T>* temp = head;
             head = head->next;
-            delete temp;
+            DestroyNode(temp);
         }
+        tail = nullptr;
         size = 0;
     }
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <utility>
 #include "Sequence.hpp"
 #include "LinkedList.hpp"
+#include "SequenceSink.hpp"
 #include "Exceptions.hpp"
 
 template <typename T>
@@ -13,49 +14,134 @@ private:
     class LinkedListEnumerator : public IEnumerator<T> {
     private:
         const LinkedList<T>& list;
-        int currentIndex;
-        T currentValue;
+        const Node<T>* current;
         bool isBeforeFirst;
 
     public:
         explicit LinkedListEnumerator(const LinkedList<T>& list) 
-            : list(list), currentIndex(-1), isBeforeFirst(true) {}
+            : list(list), current(nullptr), isBeforeFirst(true) {}
 
+        // Обход идёт по узлам, без повторного прохода от головы на каждом шаге
         bool MoveNext() override {
-            if (currentIndex + 1 < list.GetSize()) {
-                currentIndex++;
-                currentValue = list.Get(currentIndex);
+            if (isBeforeFirst) {
+                current = list.GetHead();
                 isBeforeFirst = false;
+                return current != nullptr;
+            }
+            if (current && current->next) {
+                current = current->next;
                 return true;
             }
             return false;
         }
 
         const T& Current() const override {
-            if (isBeforeFirst || currentIndex >= list.GetSize()) {
+            if (isBeforeFirst || !current) {
                 throw InvalidStateException("Enumerator is not in a valid position");
             }
-            return currentValue;
+            return current->data;
         }
 
         void Reset() override {
-            currentIndex = -1;
+            current = nullptr;
             isBeforeFirst = true;
         }
     };
 
+protected:
+    // Имя класса в событиях трассировки; наследники возвращают своё
+    virtual const char* GetTraceName() const {
+        return "ListSequence";
+    }
+
+    // Операции проходят по узлам напрямую: Get(i) у списка линеен,
+    // и обход через него делал бы каждую операцию квадратичной.
+    static void AppendAll(const Sequence<T>* source, LinkedList<T>& result) {
+        IEnumerator<T>* enumerator = source->GetEnumerator();
+        while (enumerator->MoveNext()) {
+            result.Append(enumerator->Current());
+        }
+        delete enumerator;
+    }
+
+    void MapInto(T (*func)(const T&), LinkedList<T>& result) const {
+        for (const Node<T>* node = list.GetHead(); node; node = node->next) {
+            result.Append(func(node->data));
+        }
+    }
+
+    void WhereInto(bool (*predicate)(const T&), LinkedList<T>& result) const {
+        for (const Node<T>* node = list.GetHead(); node; node = node->next) {
+            if (predicate(node->data)) {
+                result.Append(node->data);
+            }
+        }
+    }
+
+    void SliceInto(int i, int N, const Sequence<T>* s, LinkedList<T>& result) const {
+        int length = list.GetSize();
+        
+        if (i < 0) {
+            i = length + i;
+        }
+        if (i < 0 || i >= length) {
+            throw IndexOutOfRangeException("Invalid slice index");
+        }
+        if (i + N > length) {
+            N = length - i;
+        }
+
+        const Node<T>* node = list.GetHead();
+        for (int j = 0; j < i; ++j, node = node->next) {
+            result.Append(node->data);
+        }
+        if (s != nullptr) {
+            AppendAll(s, result);
+        }
+        for (int j = i; j < i + N; ++j) {
+            node = node->next;
+        }
+        for (; node; node = node->next) {
+            result.Append(node->data);
+        }
+    }
+
+    void FlatMapInto(Sequence<T>* (*func)(const T&), LinkedList<T>& result) const {
+        for (const Node<T>* node = list.GetHead(); node; node = node->next) {
+            Sequence<T>* subseq = func(node->data);
+            AppendAll(subseq, result);
+            delete subseq;
+        }
+    }
+
+    void FlatMapInto(void (*func)(const T&, ISequenceSink<T>&), LinkedList<T>& result) const {
+        LinkedListSink<T> sink(result);
+        for (const Node<T>* node = list.GetHead(); node; node = node->next) {
+            func(node->data, sink);
+        }
+    }
+
+    void SplitInto(bool (*predicate)(const T&), LinkedList<T>& matching, LinkedList<T>& notMatching) const {
+        for (const Node<T>* node = list.GetHead(); node; node = node->next) {
+            if (predicate(node->data)) {
+                matching.Append(node->data);
+            } else {
+                notMatching.Append(node->data);
+            }
+        }
+    }
+
+    void ConcatInto(const Sequence<T>* other, LinkedList<T>& result) const {
+        result = list;
+        AppendAll(other, result);
+    }
+
 public:
     ListSequence() = default;
     ListSequence(T* items, int count) : list(items, count) {}
-    ListSequence(const T* items, int count) {
-        T* nonConstItems = new T[count];
-        for (int i = 0; i < count; ++i) {
-            nonConstItems[i] = items[i];
-        }
-        list = LinkedList<T>(nonConstItems, count);
-        delete[] nonConstItems;
-    }
+    ListSequence(const T* items, int count) : list(items, count) {}
     ListSequence(const LinkedList<T>& other) : list(other) {}
+    ListSequence(LinkedList<T>&& other) : list(std::move(other)) {}
     // from
     ListSequence(const ListSequence<T>& other) : list(other.list) {}
 
@@ -99,13 +185,14 @@ public:
         if (startIndex < 0 || endIndex >= list.GetSize() || startIndex > endIndex) {
             throw IndexOutOfRangeException("Invalid subsequence indices");
         }
-        int length = endIndex - startIndex + 1;
-        T* items = new T[length];
-        for (int i = 0; i < length; ++i) {
-            items[i] = list.Get(startIndex + i);
+        ListSequence<T>* result = new ListSequence<T>();
+        const Node<T>* node = list.GetHead();
+        for (int i = 0; i < startIndex; ++i) {
+            node = node->next;
+        }
+        for (int i = startIndex; i <= endIndex; ++i, node = node->next) {
+            result->list.Append(node->data);
         }
-        ListSequence<T>* result = new ListSequence<T>(items, length);
-        delete[] items;
         return result;
     }
 
@@ -113,6 +200,14 @@ public:
         return list.GetSize();
     }
 
+    // Накладные расходы — указатель и выравнивание в каждом узле
+    MemoryUsage MemoryFootprint() const override {
+        MemoryUsage usage;
+        usage.payloadBytes = static_cast<long long>(sizeof(T)) * list.GetSize();
+        usage.overheadBytes = static_cast<long long>(sizeof(Node<T>) - sizeof(T)) * list.GetSize();
+        return usage;
+    }
+
     void Append(const T& item) override {
         list.Append(item);
     }
@@ -126,116 +221,84 @@ public:
     }
 
     Sequence<T>* Map(T (*func)(const T&)) const override {
-        ListSequence<T>* result = new ListSequence<T>();
-        for (int i = 0; i < list.GetSize(); ++i) {
-            result->Append(func(list.Get(i)));
-        }
-        return result;
+        SEQUENCE_TRACE_SCOPE("Map", GetTraceName());
+        LinkedList<T> result;
+        MapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ListSequence<T>(std::move(result));
     }
 
     Sequence<T>* Where(bool (*predicate)(const T&)) const override {
-        ListSequence<T>* result = new ListSequence<T>();
-        for (int i = 0; i < list.GetSize(); ++i) {
-            T item = list.Get(i);
-            if (predicate(item)) {
-                result->Append(item);
-            }
-        }
-        return result;
+        SEQUENCE_TRACE_SCOPE("Where", GetTraceName());
+        LinkedList<T> result;
+        WhereInto(predicate, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ListSequence<T>(std::move(result));
     }
 
     T Reduce(T (*func)(const T&, const T&), const T& initial) const override {
+        SEQUENCE_TRACE_SCOPE("Reduce", GetTraceName());
         T result = initial;
-        for (int i = 0; i < list.GetSize(); ++i) {
-            result = func(result, list.Get(i));
+        for (const Node<T>* node = list.GetHead(); node; node = node->next) {
+            result = func(result, node->data);
         }
         return result;
     }
 
     Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const override {
-        int length = list.GetSize();
-        
-        if (i < 0) {
-            i = length + i;
-        }
-        if (i < 0 || i >= length) {
-            throw IndexOutOfRangeException("Invalid slice index");
-        }
-        if (i + N > length) {
-            N = length - i;
-        }
-        
-        ListSequence<T>* result = new ListSequence<T>();
-        
-        for (int j = 0; j < i; ++j) {
-            result->Append(list.Get(j));
-        }
-        
-        if (s != nullptr) {
-            for (int j = 0; j < s->GetLength(); ++j) {
-                result->Append(s->Get(j));
-            }
-        }
-
-        for (int j = i + N; j < length; ++j) {
-            result->Append(list.Get(j));
-        }
-        
-        return result;
+        SEQUENCE_TRACE_SCOPE("Slice", GetTraceName());
+        LinkedList<T> result;
+        SliceInto(i, N, s, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ListSequence<T>(std::move(result));
     }
 
     Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const override {
-        ListSequence<T>* result = new ListSequence<T>();
-        for (int i = 0; i < list.GetSize(); ++i) {
-            Sequence<T>* subseq = func(list.Get(i));
-            for (int j = 0; j < subseq->GetLength(); ++j) {
-                result->Append(subseq->Get(j));
-            }
-            delete subseq;
-        }
-        return result;
+        SEQUENCE_TRACE_SCOPE("FlatMap", GetTraceName());
+        LinkedList<T> result;
+        FlatMapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ListSequence<T>(std::move(result));
+    }
+
+    Sequence<T>* FlatMap(void (*func)(const T&, ISequenceSink<T>&)) const override {
+        SEQUENCE_TRACE_SCOPE("FlatMap", GetTraceName());
+        LinkedList<T> result;
+        FlatMapInto(func, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ListSequence<T>(std::move(result));
     }
 
     Option<T> Find(bool (*predicate)(const T&)) const override {
-        for (int i = 0; i < list.GetSize(); ++i) {
-            if (predicate(list.Get(i))) {
-                return Option<T>::Some(list.Get(i));
+        SEQUENCE_TRACE_SCOPE("Find", GetTraceName());
+        for (const Node<T>* node = list.GetHead(); node; node = node->next) {
+            if (predicate(node->data)) {
+                return Option<T>::Some(node->data);
             }
         }
         return Option<T>::None();
     }
 
     std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const override {
-        ListSequence<T>* matching = new ListSequence<T>();
-        ListSequence<T>* notMatching = new ListSequence<T>();
-
-        for (int i = 0; i < list.GetSize(); ++i) {
-            T current = list.Get(i);
-            if (predicate(current)) {
-                matching->Append(current);
-            } else {
-                notMatching->Append(current);
-            }
-        }
-
-        return std::make_pair(matching, notMatching);
+        SEQUENCE_TRACE_SCOPE("Split", GetTraceName());
+        LinkedList<T> matching;
+        LinkedList<T> notMatching;
+        SplitInto(predicate, matching, notMatching);
+        SEQUENCE_TRACE_OUTPUT(matching.GetSize() + notMatching.GetSize());
+        return std::make_pair(new ListSequence<T>(std::move(matching)),
+                              new ListSequence<T>(std::move(notMatching)));
     }
 
     Sequence<T>* Concat(const Sequence<T>* other) const override {
-        ListSequence<T>* result = new ListSequence<T>();
-        
-        for (int i = 0; i < list.GetSize(); ++i) {
-            result->Append(list.Get(i));
-        }
-        
-        for (int i = 0; i < other->GetLength(); ++i) {
-            result->Append(other->Get(i));
-        }
-        
-        return result;
+        SEQUENCE_TRACE_SCOPE("Concat", GetTraceName());
+        LinkedList<T> result;
+        ConcatInto(other, result);
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ListSequence<T>(std::move(result));
     }
 
     IEnumerator<T>* GetEnumerator() const override {
+        SEQUENCE_COUNT(EnumeratorAllocations, 1);
         return new LinkedListEnumerator(list);
     }
 };
\ No newline at end of file
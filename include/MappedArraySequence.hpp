@@ -0,0 +1,223 @@
+#pragma once
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ReadOnlySequence.hpp"
+#include "SequenceSerialization.hpp"
+#include "Exceptions.hpp"
+
+// Последовательность только для чтения поверх файла в формате SequenceSerializer,
+// отображённого в память через mmap. Конструктор читает лишь заголовок, страницы
+// данных подгружаются ядром при первом обращении. На время сплошных проходов
+// (Map, Where, Reduce, перечисление) ядру даётся подсказка MADV_SEQUENTIAL;
+// обычный режим возвращается, когда завершается последний из одновременных проходов.
+// Контрольная сумма при открытии не проверяется — это прочитало бы весь файл;
+// для проверки есть VerifyChecksum.
+template <typename T>
+class MappedArraySequence : public ReadOnlySequence<T> {
+    static_assert(SequenceCodec<T>::IsRaw, "MappedArraySequence needs a trivially copyable element type");
+
+private:
+    class MappedEnumerator : public IEnumerator<T> {
+    private:
+        const MappedArraySequence<T>& sequence;
+        int currentIndex;
+
+    public:
+        explicit MappedEnumerator(const MappedArraySequence<T>& sequence) : sequence(sequence), currentIndex(-1) {
+            sequence.BeginScan();
+        }
+
+        ~MappedEnumerator() override {
+            sequence.EndScan();
+        }
+
+        bool MoveNext() override {
+            if (currentIndex + 1 < sequence.length) {
+                currentIndex++;
+                return true;
+            }
+            return false;
+        }
+
+        const T& Current() const override {
+            if (currentIndex < 0 || currentIndex >= sequence.length) {
+                throw InvalidStateException("Enumerator is not in a valid position");
+            }
+            return sequence.items[currentIndex];
+        }
+
+        void Reset() override {
+            currentIndex = -1;
+        }
+    };
+
+    // Подсказка на время одного прохода
+    class SequentialScan {
+    private:
+        const MappedArraySequence<T>& sequence;
+
+    public:
+        explicit SequentialScan(const MappedArraySequence<T>& sequence) : sequence(sequence) {
+            sequence.BeginScan();
+        }
+
+        ~SequentialScan() {
+            sequence.EndScan();
+        }
+    };
+
+    void* mapping;
+    std::size_t mappingSize;
+    SequenceFileHeader header;
+    const T* items;
+    int length;
+    // Число активных проходов; подсказка общая на всё отображение
+    mutable std::mutex scanMutex;
+    mutable int activeScans;
+
+    // Ошибки madvise не критичны: это только подсказка
+    void Advise(int advice) const {
+        if (mappingSize > 0) {
+            madvise(mapping, mappingSize, advice);
+        }
+    }
+
+    // Под мьютексом, чтобы MADV_NORMAL завершившегося прохода не обогнал
+    // MADV_SEQUENTIAL только что начавшегося
+    void BeginScan() const {
+        std::lock_guard<std::mutex> lock(scanMutex);
+        if (activeScans++ == 0) {
+            Advise(MADV_SEQUENTIAL);
+        }
+    }
+
+    void EndScan() const {
+        std::lock_guard<std::mutex> lock(scanMutex);
+        if (--activeScans == 0) {
+            Advise(MADV_NORMAL);
+        }
+    }
+
+public:
+    explicit MappedArraySequence(const std::string& path) : mapping(MAP_FAILED), mappingSize(0), items(nullptr), length(0), activeScans(0) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw InvalidArgumentException("Cannot open file '" + path + "'");
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw InvalidStateException("Cannot stat file '" + path + "'");
+        }
+        if (static_cast<std::size_t>(info.st_size) < sizeof(SequenceFileHeader)) {
+            close(fd);
+            throw SerializationException("Truncated sequence header");
+        }
+        mappingSize = static_cast<std::size_t>(info.st_size);
+        mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            throw InvalidStateException("Cannot map file '" + path + "'");
+        }
+
+        std::memcpy(&header, mapping, sizeof(header));
+        try {
+            SequenceSerializer<T>::ValidateHeader(header);
+            std::size_t expected = sizeof(SequenceFileHeader) + sizeof(T) * static_cast<std::size_t>(header.length);
+            if (mappingSize != expected) {
+                throw SerializationException("File size does not match sequence length");
+            }
+        } catch (...) {
+            munmap(mapping, mappingSize);
+            throw;
+        }
+        // Заголовок 32 байта, отображение выровнено по странице — элементы выровнены
+        items = reinterpret_cast<const T*>(static_cast<const char*>(mapping) + sizeof(SequenceFileHeader));
+        length = static_cast<int>(header.length);
+    }
+
+    MappedArraySequence(const MappedArraySequence&) = delete;
+    MappedArraySequence& operator=(const MappedArraySequence&) = delete;
+
+    ~MappedArraySequence() override {
+        munmap(mapping, mappingSize);
+    }
+
+    // Читает весь файл и сверяет контрольную сумму из заголовка
+    bool VerifyChecksum() const {
+        SequentialScan scan(*this);
+        SequenceChecksum checksum;
+        checksum.Update(items, sizeof(T) * static_cast<std::size_t>(length));
+        return checksum.Finish() == header.checksum;
+    }
+
+    T Get(int index) const override {
+        if (index < 0 || index >= length) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        return items[index];
+    }
+
+    int GetLength() const override {
+        return length;
+    }
+
+    // Отображённые байты файла; в куче последовательность почти ничего не держит
+    MemoryUsage MemoryFootprint() const override {
+        MemoryUsage usage;
+        usage.payloadBytes = static_cast<long long>(sizeof(T)) * length;
+        usage.overheadBytes = static_cast<long long>(sizeof(SequenceFileHeader));
+        return usage;
+    }
+
+    const T* GetData() const {
+        return items;
+    }
+
+    Sequence<T>* Map(T (*func)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("Map", "MappedArraySequence");
+        SequentialScan scan(*this);
+        DynamicArray<T> result(length);
+        T* target = result.GetData();
+        for (int i = 0; i < length; ++i) {
+            target[i] = func(items[i]);
+        }
+        SEQUENCE_TRACE_OUTPUT(length);
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    Sequence<T>* Where(bool (*predicate)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("Where", "MappedArraySequence");
+        SequentialScan scan(*this);
+        DynamicArray<T> result;
+        DynamicArraySink<T> sink(result);
+        for (int i = 0; i < length; ++i) {
+            if (predicate(items[i])) {
+                sink.Push(items[i]);
+            }
+        }
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    T Reduce(T (*func)(const T&, const T&), const T& initial) const override {
+        SEQUENCE_TRACE_SCOPE("Reduce", "MappedArraySequence");
+        SequentialScan scan(*this);
+        T result = initial;
+        for (int i = 0; i < length; ++i) {
+            result = func(result, items[i]);
+        }
+        return result;
+    }
+
+    IEnumerator<T>* GetEnumerator() const override {
+        SEQUENCE_COUNT(EnumeratorAllocations, 1);
+        return new MappedEnumerator(*this);
+    }
+};
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+
+// Разбивка памяти, которую держит последовательность, в байтах
+struct MemoryUsage {
+    long long payloadBytes = 0;   // сами элементы
+    long long slackBytes = 0;     // выделенная, но не занятая ёмкость
+    long long overheadBytes = 0;  // служебные данные (указатели узлов и т.п.)
+
+    long long GetTotalBytes() const {
+        return payloadBytes + slackBytes + overheadBytes;
+    }
+};
+
+// Учёт памяти хранилищ библиотеки (DynamicArray, узлы LinkedList): сколько байт
+// занято сейчас и каков был максимум. Включается вместе со счётчиками опцией CMake
+// SEQUENCE_INSTRUMENTATION: каждое выделение иначе платило бы за общий атомарный
+// счётчик и CAS максимума. Без опции OnAllocate/OnFree пусты, а замеры равны нулю.
+// Счётчики общие для всех потоков и обновляются relaxed-атомиками, поэтому значения
+// приблизительны во время работы потоков и точны после их завершения. Накладные
+// расходы malloc не учитываются.
+class MemoryTracker {
+#ifdef SEQUENCE_INSTRUMENTATION
+private:
+    static std::atomic<long long>& LiveBytes() {
+        static std::atomic<long long> liveBytes{0};
+        return liveBytes;
+    }
+
+    static std::atomic<long long>& PeakBytes() {
+        static std::atomic<long long> peakBytes{0};
+        return peakBytes;
+    }
+
+public:
+    static constexpr bool Enabled = true;
+
+    static void OnAllocate(long long bytes) {
+        long long live = LiveBytes().fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        long long peak = PeakBytes().load(std::memory_order_relaxed);
+        while (live > peak && !PeakBytes().compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void OnFree(long long bytes) {
+        LiveBytes().fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    static long long GetLiveBytes() {
+        return LiveBytes().load(std::memory_order_relaxed);
+    }
+
+    static long long GetPeakBytes() {
+        return PeakBytes().load(std::memory_order_relaxed);
+    }
+
+    // Начинает новый замер максимума с текущего уровня
+    static void ResetPeak() {
+        PeakBytes().store(GetLiveBytes(), std::memory_order_relaxed);
+    }
+#else
+public:
+    static constexpr bool Enabled = false;
+
+    static void OnAllocate(long long) {}
+
+    static void OnFree(long long) {}
+
+    static long long GetLiveBytes() {
+        return 0;
+    }
+
+    static long long GetPeakBytes() {
+        return 0;
+    }
+
+    static void ResetPeak() {}
+#endif
+};
@@ -0,0 +1,327 @@
+#pragma once
+#include <utility>
+#include "Sequence.hpp"
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+
+// Последовательность пар, хранящая first и second в двух отдельных столбцах.
+// Проход по одному столбцу читает только его память, а Unzip отдаёт столбцы без копирования.
+template <typename T, typename U>
+class PairColumnSequence : public Sequence<std::pair<T, U>> {
+private:
+    using Pair = std::pair<T, U>;
+
+    DynamicArray<T> firstColumn;
+    DynamicArray<U> secondColumn;
+
+    class PairColumnEnumerator : public IEnumerator<Pair> {
+    private:
+        const PairColumnSequence<T, U>& sequence;
+        int currentIndex;
+        Pair currentValue;
+
+    public:
+        explicit PairColumnEnumerator(const PairColumnSequence<T, U>& sequence)
+            : sequence(sequence), currentIndex(-1) {}
+
+        bool MoveNext() override {
+            if (currentIndex + 1 < sequence.GetLength()) {
+                currentIndex++;
+                currentValue = sequence.GetUnchecked(currentIndex);
+                return true;
+            }
+            return false;
+        }
+
+        const Pair& Current() const override {
+            if (currentIndex < 0 || currentIndex >= sequence.GetLength()) {
+                throw InvalidStateException("Enumerator is not in a valid position");
+            }
+            return currentValue;
+        }
+
+        void Reset() override {
+            currentIndex = -1;
+        }
+    };
+
+    Pair GetUnchecked(int index) const {
+        return Pair(firstColumn.GetData()[index], secondColumn.GetData()[index]);
+    }
+
+    void SetUnchecked(int index, const Pair& item) {
+        firstColumn.GetData()[index] = item.first;
+        secondColumn.GetData()[index] = item.second;
+    }
+
+    void PushBack(const Pair& item) {
+        int oldSize = firstColumn.GetSize();
+        if (oldSize == firstColumn.GetCapacity()) {
+            int newCapacity = oldSize < 8 ? 8 : oldSize * 2;
+            firstColumn.Reserve(newCapacity);
+            secondColumn.Reserve(newCapacity);
+        }
+        firstColumn.Resize(oldSize + 1);
+        secondColumn.Resize(oldSize + 1);
+        SetUnchecked(oldSize, item);
+    }
+
+    class ColumnSink : public ISequenceSink<Pair> {
+    private:
+        PairColumnSequence<T, U>& target;
+
+    public:
+        explicit ColumnSink(PairColumnSequence<T, U>& target) : target(target) {}
+
+        void Push(const Pair& item) override {
+            target.PushBack(item);
+        }
+    };
+
+public:
+    PairColumnSequence() = default;
+    PairColumnSequence(const Pair* items, int count) : firstColumn(count), secondColumn(count) {
+        for (int i = 0; i < count; ++i) {
+            SetUnchecked(i, items[i]);
+        }
+    }
+    PairColumnSequence(const DynamicArray<T>& first, const DynamicArray<U>& second)
+        : firstColumn(first), secondColumn(second) {
+        if (firstColumn.GetSize() != secondColumn.GetSize()) {
+            throw InvalidArgumentException("Columns must have equal length");
+        }
+    }
+    PairColumnSequence(DynamicArray<T>&& first, DynamicArray<U>&& second)
+        : firstColumn(std::move(first)), secondColumn(std::move(second)) {
+        if (firstColumn.GetSize() != secondColumn.GetSize()) {
+            throw InvalidArgumentException("Columns must have equal length");
+        }
+    }
+    // from
+    PairColumnSequence(const PairColumnSequence<T, U>& other)
+        : firstColumn(other.firstColumn), secondColumn(other.secondColumn) {}
+
+    const DynamicArray<T>& GetFirstColumn() const {
+        return firstColumn;
+    }
+
+    const DynamicArray<U>& GetSecondColumn() const {
+        return secondColumn;
+    }
+
+    // Забирает столбцы за O(1); последовательность после этого пуста
+    std::pair<DynamicArray<T>, DynamicArray<U>> ReleaseColumns() {
+        std::pair<DynamicArray<T>, DynamicArray<U>> columns(std::move(firstColumn), std::move(secondColumn));
+        firstColumn = DynamicArray<T>();
+        secondColumn = DynamicArray<U>();
+        return columns;
+    }
+
+    Pair Get(int index) const override {
+        if (index < 0 || index >= GetLength()) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        return GetUnchecked(index);
+    }
+
+    Pair GetFirst() const override {
+        if (GetLength() == 0) {
+            throw EmptySequenceException();
+        }
+        return GetUnchecked(0);
+    }
+
+    Pair GetLast() const override {
+        if (GetLength() == 0) {
+            throw EmptySequenceException();
+        }
+        return GetUnchecked(GetLength() - 1);
+    }
+
+    Option<Pair> TryGet(int index) const override {
+        if (index < 0 || index >= GetLength()) {
+            return Option<Pair>::None();
+        }
+        return Option<Pair>::Some(GetUnchecked(index));
+    }
+
+    Option<Pair> TryGetFirst() const override {
+        if (GetLength() == 0) {
+            return Option<Pair>::None();
+        }
+        return Option<Pair>::Some(GetUnchecked(0));
+    }
+
+    Option<Pair> TryGetLast() const override {
+        if (GetLength() == 0) {
+            return Option<Pair>::None();
+        }
+        return Option<Pair>::Some(GetUnchecked(GetLength() - 1));
+    }
+
+    int GetLength() const override {
+        return firstColumn.GetSize();
+    }
+
+    // Столбцы хранятся без выравнивания пары, поэтому полезная нагрузка меньше sizeof(Pair)·n
+    MemoryUsage MemoryFootprint() const override {
+        MemoryUsage usage;
+        usage.payloadBytes = static_cast<long long>(sizeof(T) + sizeof(U)) * firstColumn.GetSize();
+        usage.slackBytes = static_cast<long long>(sizeof(T)) * (firstColumn.GetCapacity() - firstColumn.GetSize())
+                         + static_cast<long long>(sizeof(U)) * (secondColumn.GetCapacity() - secondColumn.GetSize());
+        return usage;
+    }
+
+    Sequence<Pair>* GetSubsequence(int startIndex, int endIndex) const override {
+        if (startIndex < 0 || endIndex >= GetLength() || startIndex > endIndex) {
+            throw IndexOutOfRangeException("Invalid subsequence indices");
+        }
+        int length = endIndex - startIndex + 1;
+        DynamicArray<T> first(firstColumn.GetData() + startIndex, length);
+        DynamicArray<U> second(secondColumn.GetData() + startIndex, length);
+        return new PairColumnSequence<T, U>(std::move(first), std::move(second));
+    }
+
+    void Append(const Pair& item) override {
+        PushBack(item);
+    }
+
+    void Prepend(const Pair& item) override {
+        InsertAt(item, 0);
+    }
+
+    void InsertAt(const Pair& item, int index) override {
+        if (index < 0 || index > GetLength()) {
+            throw IndexOutOfRangeException("Invalid insert index");
+        }
+        int oldSize = GetLength();
+        PushBack(item);
+        T* first = firstColumn.GetData();
+        U* second = secondColumn.GetData();
+        for (int i = oldSize; i > index; --i) {
+            first[i] = first[i - 1];
+            second[i] = second[i - 1];
+        }
+        SetUnchecked(index, item);
+    }
+
+    Sequence<Pair>* Map(Pair (*func)(const Pair&)) const override {
+        int length = GetLength();
+        PairColumnSequence<T, U>* result = new PairColumnSequence<T, U>(DynamicArray<T>(length), DynamicArray<U>(length));
+        for (int i = 0; i < length; ++i) {
+            result->SetUnchecked(i, func(GetUnchecked(i)));
+        }
+        return result;
+    }
+
+    Sequence<Pair>* Where(bool (*predicate)(const Pair&)) const override {
+        PairColumnSequence<T, U>* result = new PairColumnSequence<T, U>();
+        for (int i = 0; i < GetLength(); ++i) {
+            Pair current = GetUnchecked(i);
+            if (predicate(current)) {
+                result->PushBack(current);
+            }
+        }
+        return result;
+    }
+
+    Pair Reduce(Pair (*func)(const Pair&, const Pair&), const Pair& initial) const override {
+        Pair result = initial;
+        for (int i = 0; i < GetLength(); ++i) {
+            result = func(result, GetUnchecked(i));
+        }
+        return result;
+    }
+
+    Sequence<Pair>* FlatMap(Sequence<Pair>* (*func)(const Pair&)) const override {
+        PairColumnSequence<T, U>* result = new PairColumnSequence<T, U>();
+        for (int i = 0; i < GetLength(); ++i) {
+            Sequence<Pair>* subseq = func(GetUnchecked(i));
+            IEnumerator<Pair>* enumerator = subseq->GetEnumerator();
+            while (enumerator->MoveNext()) {
+                result->PushBack(enumerator->Current());
+            }
+            delete enumerator;
+            delete subseq;
+        }
+        return result;
+    }
+
+    Sequence<Pair>* FlatMap(void (*func)(const Pair&, ISequenceSink<Pair>&)) const override {
+        PairColumnSequence<T, U>* result = new PairColumnSequence<T, U>();
+        ColumnSink sink(*result);
+        for (int i = 0; i < GetLength(); ++i) {
+            func(GetUnchecked(i), sink);
+        }
+        return result;
+    }
+
+    Option<Pair> Find(bool (*predicate)(const Pair&)) const override {
+        for (int i = 0; i < GetLength(); ++i) {
+            Pair current = GetUnchecked(i);
+            if (predicate(current)) {
+                return Option<Pair>::Some(current);
+            }
+        }
+        return Option<Pair>::None();
+    }
+
+    std::pair<Sequence<Pair>*, Sequence<Pair>*> Split(bool (*predicate)(const Pair&)) const override {
+        PairColumnSequence<T, U>* matching = new PairColumnSequence<T, U>();
+        PairColumnSequence<T, U>* notMatching = new PairColumnSequence<T, U>();
+        for (int i = 0; i < GetLength(); ++i) {
+            Pair current = GetUnchecked(i);
+            if (predicate(current)) {
+                matching->PushBack(current);
+            } else {
+                notMatching->PushBack(current);
+            }
+        }
+        return std::make_pair(matching, notMatching);
+    }
+
+    Sequence<Pair>* Concat(const Sequence<Pair>* other) const override {
+        PairColumnSequence<T, U>* result = new PairColumnSequence<T, U>(*this);
+        IEnumerator<Pair>* enumerator = other->GetEnumerator();
+        while (enumerator->MoveNext()) {
+            result->PushBack(enumerator->Current());
+        }
+        delete enumerator;
+        return result;
+    }
+
+    Sequence<Pair>* Slice(int i, int N, const Sequence<Pair>* s = nullptr) const override {
+        int length = GetLength();
+
+        if (i < 0) {
+            i = length + i;
+        }
+        if (i < 0 || i >= length) {
+            throw IndexOutOfRangeException("Invalid slice index");
+        }
+        if (i + N > length) {
+            N = length - i;
+        }
+
+        PairColumnSequence<T, U>* result = new PairColumnSequence<T, U>();
+        for (int j = 0; j < i; ++j) {
+            result->PushBack(GetUnchecked(j));
+        }
+        if (s != nullptr) {
+            IEnumerator<Pair>* enumerator = s->GetEnumerator();
+            while (enumerator->MoveNext()) {
+                result->PushBack(enumerator->Current());
+            }
+            delete enumerator;
+        }
+        for (int j = i + N; j < length; ++j) {
+            result->PushBack(GetUnchecked(j));
+        }
+        return result;
+    }
+
+    IEnumerator<Pair>* GetEnumerator() const override {
+        SEQUENCE_COUNT(EnumeratorAllocations, 1);
+        return new PairColumnEnumerator(*this);
+    }
+};
@@ -0,0 +1,254 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include "DynamicArray.hpp"
+#include "ThreadPool.hpp"
+
+// Сортировки массивов на пуле потоков библиотеки.
+//
+// ParallelMergeSort: чанки сортируются независимо, затем сливаются попарно. Каждое
+// слияние пары делится на части по выходу: граница части во входах находится
+// двоичным поиском (co-rank), так что и последние слияния идут параллельно.
+// Стабильна, если чанки сортируются стабильно.
+//
+// RadixSort: LSD по байтам для целых и float/double. Гистограммы и раскладка
+// считаются по чанкам параллельно; проход, в котором у всех ключей один и тот же
+// байт, пропускается. Всегда стабильна.
+
+// Размер, ниже которого поразрядная сортировка проигрывает std::sort
+constexpr int RadixSortThreshold = 2048;
+
+template <typename T, typename Enable = void>
+struct RadixTraits {
+    static constexpr bool Supported = false;
+};
+
+// Целые: у знаковых инвертируется старший бит, чтобы отрицательные шли первыми
+template <typename T>
+struct RadixTraits<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+    static constexpr bool Supported = true;
+    using Bits = typename std::make_unsigned<T>::type;
+
+    static Bits Encode(T value) {
+        Bits bits = static_cast<Bits>(value);
+        if (std::is_signed<T>::value) {
+            bits ^= Bits(1) << (sizeof(T) * 8 - 1);
+        }
+        return bits;
+    }
+};
+
+// IEEE 754: у отрицательных инвертируются все биты, у остальных — знаковый
+template <typename T>
+struct RadixTraits<T, typename std::enable_if<std::is_floating_point<T>::value && (sizeof(T) == 4 || sizeof(T) == 8)>::type> {
+    static constexpr bool Supported = true;
+    using Bits = typename std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>::type;
+
+    static Bits Encode(T value) {
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        Bits sign = Bits(1) << (sizeof(T) * 8 - 1);
+        return (bits & sign) ? ~bits : (bits | sign);
+    }
+};
+
+// Пустая полезная нагрузка для RadixSortWithPayload
+struct NoRadixPayload {};
+
+template <typename Key, typename Payload>
+void RadixSortWithPayload(Key* keys, Payload* payload, int length) {
+    static_assert(RadixTraits<Key>::Supported, "RadixSort needs an integer or float key");
+    constexpr bool HasPayload = !std::is_same<Payload, NoRadixPayload>::value;
+    constexpr int Buckets = 256;
+    if (length < 2) {
+        return;
+    }
+
+    int chunkCount = ParallelChunkCount(length);
+    DynamicArray<Key> keyBuffer(length);
+    DynamicArray<Payload> payloadBuffer(HasPayload ? length : 0);
+    DynamicArray<int> histogram(chunkCount * Buckets);
+    int* counts = histogram.GetData();
+
+    Key* sourceKeys = keys;
+    Key* targetKeys = keyBuffer.GetData();
+    Payload* sourcePayload = payload;
+    Payload* targetPayload = payloadBuffer.GetData();
+
+    for (int pass = 0; pass < static_cast<int>(sizeof(Key)); ++pass) {
+        int shift = pass * 8;
+        ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+            int begin, end;
+            GetChunkRange(length, chunkCount, chunk, begin, end);
+            int* local = counts + chunk * Buckets;
+            std::fill(local, local + Buckets, 0);
+            for (int i = begin; i < end; ++i) {
+                ++local[(RadixTraits<Key>::Encode(sourceKeys[i]) >> shift) & 0xFF];
+            }
+        });
+
+        // Смещения в порядке (байт, чанк) — так раскладка остаётся стабильной
+        bool trivial = false;
+        int total = 0;
+        for (int digit = 0; digit < Buckets; ++digit) {
+            int digitStart = total;
+            for (int chunk = 0; chunk < chunkCount; ++chunk) {
+                int count = counts[chunk * Buckets + digit];
+                counts[chunk * Buckets + digit] = total;
+                total += count;
+            }
+            if (total - digitStart == length) {
+                trivial = true;
+            }
+        }
+        if (trivial) {
+            continue;
+        }
+
+        ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+            int begin, end;
+            GetChunkRange(length, chunkCount, chunk, begin, end);
+            int* offsets = counts + chunk * Buckets;
+            for (int i = begin; i < end; ++i) {
+                int position = offsets[(RadixTraits<Key>::Encode(sourceKeys[i]) >> shift) & 0xFF]++;
+                targetKeys[position] = sourceKeys[i];
+                if constexpr (HasPayload) {
+                    targetPayload[position] = std::move(sourcePayload[i]);
+                }
+            }
+        });
+        std::swap(sourceKeys, targetKeys);
+        std::swap(sourcePayload, targetPayload);
+    }
+
+    if (sourceKeys != keys) {
+        int chunks = ParallelChunkCount(length);
+        ThreadPool::Instance().ParallelFor(chunks, [&](int chunk) {
+            int begin, end;
+            GetChunkRange(length, chunks, chunk, begin, end);
+            std::copy(sourceKeys + begin, sourceKeys + end, keys + begin);
+            if constexpr (HasPayload) {
+                std::move(sourcePayload + begin, sourcePayload + end, payload + begin);
+            }
+        });
+    }
+}
+
+template <typename T>
+void RadixSort(T* items, int length) {
+    RadixSortWithPayload<T, NoRadixPayload>(items, nullptr, length);
+}
+
+// Сколько элементов first должно попасть в первые k элементов стабильного слияния
+// first и second (при равенстве первыми идут элементы first)
+template <typename T, typename Compare>
+int MergeCoRank(int k, const T* first, int firstLength, const T* second, int secondLength, Compare& compare) {
+    int low = std::max(0, k - secondLength);
+    int high = std::min(k, firstLength);
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (!compare(second[k - middle - 1], first[middle])) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+template <typename T, typename Compare>
+void ParallelMergeSort(T* items, int length, Compare compare, bool stable) {
+    int chunkCount = ParallelChunkCount(length);
+    if (chunkCount == 1) {
+        if (stable) {
+            std::stable_sort(items, items + length, compare);
+        } else {
+            std::sort(items, items + length, compare);
+        }
+        return;
+    }
+
+    ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+        int begin, end;
+        GetChunkRange(length, chunkCount, chunk, begin, end);
+        if (stable) {
+            std::stable_sort(items + begin, items + end, compare);
+        } else {
+            std::sort(items + begin, items + end, compare);
+        }
+    });
+
+    // Границы отсортированных серий; после каждого раунда их вдвое меньше
+    DynamicArray<int> boundaries(chunkCount + 1);
+    int* runs = boundaries.GetData();
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        int begin, end;
+        GetChunkRange(length, chunkCount, chunk, begin, end);
+        runs[chunk] = begin;
+    }
+    runs[chunkCount] = length;
+
+    DynamicArray<T> buffer(length);
+    T* source = items;
+    T* target = buffer.GetData();
+    int runCount = chunkCount;
+    DynamicArray<int> splitPoints;
+    while (runCount > 1) {
+        int pairCount = (runCount + 1) / 2;
+        int piecesPerPair = std::max(1, chunkCount / pairCount);
+        int taskCount = pairCount * piecesPerPair;
+
+        // Сначала все границы частей, потом слияние: слияние перемещает элементы
+        // источника, и искать по нему одновременно с этим нельзя
+        splitPoints = DynamicArray<int>(taskCount + pairCount);
+        int* splits = splitPoints.GetData();
+        ThreadPool::Instance().ParallelFor(taskCount + pairCount, [&](int point) {
+            int pair = point / (piecesPerPair + 1);
+            int piece = point % (piecesPerPair + 1);
+            int begin = runs[2 * pair];
+            int middle = runs[std::min(2 * pair + 1, runCount)];
+            int end = runs[std::min(2 * pair + 2, runCount)];
+            int outBegin, outEnd;
+            GetChunkRange(end - begin, piecesPerPair, std::min(piece, piecesPerPair - 1), outBegin, outEnd);
+            int k = piece == piecesPerPair ? outEnd : outBegin;
+            splits[point] = MergeCoRank(k, source + begin, middle - begin, source + middle, end - middle, compare);
+        });
+
+        ThreadPool::Instance().ParallelFor(taskCount, [&](int task) {
+            int pair = task / piecesPerPair;
+            int piece = task % piecesPerPair;
+            int begin = runs[2 * pair];
+            int middle = runs[std::min(2 * pair + 1, runCount)];
+            int end = runs[std::min(2 * pair + 2, runCount)];
+            T* first = source + begin;
+            T* second = source + middle;
+
+            int outBegin, outEnd;
+            GetChunkRange(end - begin, piecesPerPair, piece, outBegin, outEnd);
+            int firstBegin = splits[pair * (piecesPerPair + 1) + piece];
+            int firstEnd = splits[pair * (piecesPerPair + 1) + piece + 1];
+            std::merge(std::make_move_iterator(first + firstBegin), std::make_move_iterator(first + firstEnd),
+                       std::make_move_iterator(second + outBegin - firstBegin),
+                       std::make_move_iterator(second + outEnd - firstEnd),
+                       target + begin + outBegin, compare);
+        });
+
+        for (int pair = 0; pair < pairCount; ++pair) {
+            runs[pair] = runs[2 * pair];
+        }
+        runs[pairCount] = length;
+        runCount = pairCount;
+        std::swap(source, target);
+    }
+
+    if (source != items) {
+        ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+            int begin, end;
+            GetChunkRange(length, chunkCount, chunk, begin, end);
+            std::move(source + begin, source + end, items + begin);
+        });
+    }
+}
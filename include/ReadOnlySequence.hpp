@@ -0,0 +1,238 @@
+#pragma once
+#include <utility>
+#include "Sequence.hpp"
+#include "ArraySequence.hpp"
+#include "Exceptions.hpp"
+
+// База для последовательностей, поддерживающих только чтение (представления, файлы,
+// сжатые данные). Всё выражено через Get/GetLength; изменяющие методы бросают
+// InvalidOperationException, а преобразования возвращают новый ArraySequence.
+template <typename T>
+class ReadOnlySequence : public Sequence<T> {
+private:
+    class ReadOnlyEnumerator : public IEnumerator<T> {
+    private:
+        const ReadOnlySequence<T>& sequence;
+        int currentIndex;
+        T currentValue;
+
+    public:
+        explicit ReadOnlyEnumerator(const ReadOnlySequence<T>& sequence)
+            : sequence(sequence), currentIndex(-1) {}
+
+        bool MoveNext() override {
+            if (currentIndex + 1 < sequence.GetLength()) {
+                currentIndex++;
+                currentValue = sequence.Get(currentIndex);
+                return true;
+            }
+            return false;
+        }
+
+        const T& Current() const override {
+            if (currentIndex < 0 || currentIndex >= sequence.GetLength()) {
+                throw InvalidStateException("Enumerator is not in a valid position");
+            }
+            return currentValue;
+        }
+
+        void Reset() override {
+            currentIndex = -1;
+        }
+    };
+
+protected:
+    // Копирует диапазон [begin, end) в result через Get; наследники с блочным
+    // хранением переопределяют
+    virtual void CopyRangeInto(int begin, int end, DynamicArray<T>& result) const {
+        result = DynamicArray<T>(end - begin);
+        T* items = result.GetData();
+        for (int i = begin; i < end; ++i) {
+            items[i - begin] = this->Get(i);
+        }
+    }
+
+public:
+    T GetFirst() const override {
+        if (this->GetLength() == 0) {
+            throw EmptySequenceException();
+        }
+        return this->Get(0);
+    }
+
+    T GetLast() const override {
+        if (this->GetLength() == 0) {
+            throw EmptySequenceException();
+        }
+        return this->Get(this->GetLength() - 1);
+    }
+
+    Option<T> TryGet(int index) const override {
+        if (index < 0 || index >= this->GetLength()) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(this->Get(index));
+    }
+
+    Option<T> TryGetFirst() const override {
+        if (this->GetLength() == 0) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(this->Get(0));
+    }
+
+    Option<T> TryGetLast() const override {
+        if (this->GetLength() == 0) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(this->Get(this->GetLength() - 1));
+    }
+
+    Sequence<T>* GetSubsequence(int startIndex, int endIndex) const override {
+        if (startIndex < 0 || endIndex >= this->GetLength() || startIndex > endIndex) {
+            throw IndexOutOfRangeException("Invalid subsequence indices");
+        }
+        DynamicArray<T> result;
+        CopyRangeInto(startIndex, endIndex + 1, result);
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    void Append(const T&) override {
+        throw InvalidOperationException("Cannot modify read-only sequence");
+    }
+
+    void Prepend(const T&) override {
+        throw InvalidOperationException("Cannot modify read-only sequence");
+    }
+
+    void InsertAt(const T&, int) override {
+        throw InvalidOperationException("Cannot modify read-only sequence");
+    }
+
+    Sequence<T>* Map(T (*func)(const T&)) const override {
+        int length = this->GetLength();
+        DynamicArray<T> result(length);
+        T* items = result.GetData();
+        for (int i = 0; i < length; ++i) {
+            items[i] = func(this->Get(i));
+        }
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    Sequence<T>* Where(bool (*predicate)(const T&)) const override {
+        DynamicArray<T> result;
+        DynamicArraySink<T> sink(result);
+        for (int i = 0; i < this->GetLength(); ++i) {
+            T current = this->Get(i);
+            if (predicate(current)) {
+                sink.Push(current);
+            }
+        }
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    T Reduce(T (*func)(const T&, const T&), const T& initial) const override {
+        T result = initial;
+        for (int i = 0; i < this->GetLength(); ++i) {
+            result = func(result, this->Get(i));
+        }
+        return result;
+    }
+
+    Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const override {
+        DynamicArray<T> result;
+        DynamicArraySink<T> sink(result);
+        for (int i = 0; i < this->GetLength(); ++i) {
+            Sequence<T>* subseq = func(this->Get(i));
+            IEnumerator<T>* enumerator = subseq->GetEnumerator();
+            while (enumerator->MoveNext()) {
+                sink.Push(enumerator->Current());
+            }
+            delete enumerator;
+            delete subseq;
+        }
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    Sequence<T>* FlatMap(void (*func)(const T&, ISequenceSink<T>&)) const override {
+        DynamicArray<T> result;
+        DynamicArraySink<T> sink(result);
+        for (int i = 0; i < this->GetLength(); ++i) {
+            func(this->Get(i), sink);
+        }
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    Option<T> Find(bool (*predicate)(const T&)) const override {
+        for (int i = 0; i < this->GetLength(); ++i) {
+            T current = this->Get(i);
+            if (predicate(current)) {
+                return Option<T>::Some(current);
+            }
+        }
+        return Option<T>::None();
+    }
+
+    std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const override {
+        DynamicArray<T> matching;
+        DynamicArray<T> notMatching;
+        DynamicArraySink<T> matchingSink(matching);
+        DynamicArraySink<T> notMatchingSink(notMatching);
+        for (int i = 0; i < this->GetLength(); ++i) {
+            T current = this->Get(i);
+            if (predicate(current)) {
+                matchingSink.Push(current);
+            } else {
+                notMatchingSink.Push(current);
+            }
+        }
+        return std::make_pair(new ArraySequence<T>(std::move(matching)),
+                              new ArraySequence<T>(std::move(notMatching)));
+    }
+
+    Sequence<T>* Concat(const Sequence<T>* other) const override {
+        DynamicArray<T> result;
+        CopyRangeInto(0, this->GetLength(), result);
+        DynamicArraySink<T> sink(result);
+        IEnumerator<T>* enumerator = other->GetEnumerator();
+        while (enumerator->MoveNext()) {
+            sink.Push(enumerator->Current());
+        }
+        delete enumerator;
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const override {
+        int length = this->GetLength();
+
+        if (i < 0) {
+            i = length + i;
+        }
+        if (i < 0 || i >= length) {
+            throw IndexOutOfRangeException("Invalid slice index");
+        }
+        if (i + N > length) {
+            N = length - i;
+        }
+
+        DynamicArray<T> result;
+        CopyRangeInto(0, i, result);
+        DynamicArraySink<T> sink(result);
+        if (s != nullptr) {
+            IEnumerator<T>* enumerator = s->GetEnumerator();
+            while (enumerator->MoveNext()) {
+                sink.Push(enumerator->Current());
+            }
+            delete enumerator;
+        }
+        for (int j = i + N; j < length; ++j) {
+            sink.Push(this->Get(j));
+        }
+        return new ArraySequence<T>(std::move(result));
+    }
+
+    IEnumerator<T>* GetEnumerator() const override {
+        SEQUENCE_COUNT(EnumeratorAllocations, 1);
+        return new ReadOnlyEnumerator(*this);
+    }
+};
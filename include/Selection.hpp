@@ -0,0 +1,107 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include "Sequence.hpp"
+#include "ArraySequence.hpp"
+#include "DynamicArray.hpp"
+#include "ThreadPool.hpp"
+#include "Exceptions.hpp"
+
+// Куча из не более чем k лучших по compare элементов; на вершине худший из них,
+// так что очередной элемент сравнивается только с ней
+template <typename T, typename Compare>
+class BoundedHeap {
+private:
+    DynamicArray<T> items;
+    int limit;
+    int size;
+    Compare compare;
+
+    // Порядок кучи обратный compare: std::push_heap держит на вершине «наибольший»
+    bool WorseFirst(const T& a, const T& b) const {
+        return compare(b, a);
+    }
+
+public:
+    BoundedHeap(int limit, Compare compare) : items(limit), limit(limit), size(0), compare(compare) {}
+
+    void Push(const T& item) {
+        T* data = items.GetData();
+        auto order = [this](const T& a, const T& b) { return WorseFirst(a, b); };
+        if (size < limit) {
+            data[size++] = item;
+            std::push_heap(data, data + size, order);
+        } else if (limit > 0 && compare(data[0], item)) {
+            std::pop_heap(data, data + size, order);
+            data[size - 1] = item;
+            std::push_heap(data, data + size, order);
+        }
+    }
+
+    int GetSize() const {
+        return size;
+    }
+
+    const T* GetData() const {
+        return items.GetData();
+    }
+};
+
+// k лучших элементов по compare, от лучшего к худшему; по умолчанию — k наибольших.
+// Один проход с ограниченной кучей: O(n log k) времени и O(k) памяти, поэтому
+// подходит для списков и ленивых источников. Для ArraySequence большого размера
+// кучи строятся по чанкам параллельно и объединяются в конце.
+template <typename T, typename Compare = std::less<T>>
+ArraySequence<T>* TopK(const Sequence<T>& source, int k, Compare compare = Compare()) {
+    if (k < 0) {
+        throw InvalidArgumentException("k cannot be negative");
+    }
+    int length = source.GetLength();
+    if (k > length) {
+        k = length;
+    }
+
+    DynamicArray<T> candidates;
+    const ArraySequence<T>* array = dynamic_cast<const ArraySequence<T>*>(&source);
+    int chunkCount = array != nullptr ? ParallelChunkCount(length) : 1;
+    // Кандидатов от чанков не должно быть больше, чем самих элементов
+    if (static_cast<long long>(k) * chunkCount > length) {
+        chunkCount = 1;
+    }
+    if (chunkCount > 1) {
+        const T* items = array->GetData();
+        candidates = DynamicArray<T>(chunkCount * k);
+        DynamicArray<int> found(chunkCount);
+        ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+            int begin, end;
+            GetChunkRange(length, chunkCount, chunk, begin, end);
+            BoundedHeap<T, Compare> heap(k, compare);
+            for (int i = begin; i < end; ++i) {
+                heap.Push(items[i]);
+            }
+            std::copy(heap.GetData(), heap.GetData() + heap.GetSize(), candidates.GetData() + chunk * k);
+            found[chunk] = heap.GetSize();
+        });
+        // Кучи чанков сдвигаются вплотную друг к другу
+        int total = 0;
+        T* data = candidates.GetData();
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            std::move(data + chunk * k, data + chunk * k + found[chunk], data + total);
+            total += found[chunk];
+        }
+        candidates.Resize(total);
+    } else {
+        BoundedHeap<T, Compare> heap(k, compare);
+        IEnumerator<T>* enumerator = source.GetEnumerator();
+        while (enumerator->MoveNext()) {
+            heap.Push(enumerator->Current());
+        }
+        delete enumerator;
+        candidates = DynamicArray<T>(heap.GetData(), heap.GetSize());
+    }
+
+    T* data = candidates.GetData();
+    auto betterFirst = [&compare](const T& a, const T& b) { return compare(b, a); };
+    std::partial_sort(data, data + k, data + candidates.GetSize(), betterFirst);
+    return new ArraySequence<T>(DynamicArray<T>(data, k));
+}
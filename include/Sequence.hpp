@@ -2,6 +2,9 @@
 #include <utility>
 #include "Option.hpp"
 #include "IEnumerable.hpp"
+#include "SequenceSink.hpp"
+#include "MemoryTracker.hpp"
+#include "Tracing.hpp"
 
 template<typename T>
 class Sequence : public IEnumerable<T> {
@@ -27,8 +30,16 @@ public:
     virtual Sequence<T>* Where(bool (*predicate)(const T&)) const = 0;
     virtual T Reduce(T (*func)(const T&, const T&), const T& initialValue) const = 0;
     virtual Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const = 0;
+    virtual Sequence<T>* FlatMap(void (*func)(const T&, ISequenceSink<T>&)) const = 0;
     virtual Option<T> Find(bool (*predicate)(const T&)) const = 0;
     virtual std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const = 0;
     virtual Sequence<T>* Concat(const Sequence<T>* other) const = 0;
     virtual Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const = 0;
+
+    // Память, которую держит последовательность; по умолчанию учитываются только элементы
+    virtual MemoryUsage MemoryFootprint() const {
+        MemoryUsage usage;
+        usage.payloadBytes = static_cast<long long>(sizeof(T)) * GetLength();
+        return usage;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,200 @@
+#pragma once
+#include <charconv>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "Sequence.hpp"
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+
+// Оформление вывода: скобки, разделитель и пропуск
+struct FormatStyle {
+    const char* prefix;
+    const char* separator;
+    const char* suffix;
+    const char* ellipsis;
+
+    // "[ 1, 2, 3 ]" — как в интерактивном меню
+    static FormatStyle Inline() {
+        return FormatStyle{"[ ", ", ", " ]", "..."};
+    }
+
+    // По элементу на строку — для выгрузки в файл, читается обратно BulkLoader
+    static FormatStyle Lines() {
+        return FormatStyle{"", "\n", "\n", "..."};
+    }
+};
+
+// Вывод последовательностей через перечислитель в большой буфер. Числа
+// форматируются std::to_chars, в поток уходят целые блоки. Режимы head/tail/sampled
+// позволяют заглянуть в последовательность из миллионов элементов, не печатая её целиком.
+template <typename T>
+class SequenceFormatter {
+private:
+    static const int NumberWidth = 64;
+
+    std::ostream& output;
+    FormatStyle style;
+    DynamicArray<char> buffer;
+    int position;
+
+    void Put(const char* text, int length) {
+        if (position + length > buffer.GetSize()) {
+            Flush();
+            if (length > buffer.GetSize()) {
+                output.write(text, length);
+                return;
+            }
+        }
+        std::memcpy(buffer.GetData() + position, text, length);
+        position += length;
+    }
+
+    void Put(const char* text) {
+        Put(text, static_cast<int>(std::strlen(text)));
+    }
+
+    template <typename V>
+    void PutValue(const V& value) {
+        if constexpr ((std::is_integral<V>::value && !std::is_same<V, bool>::value) || std::is_floating_point<V>::value) {
+            if (position + NumberWidth > buffer.GetSize()) {
+                Flush();
+            }
+            char* begin = buffer.GetData() + position;
+            std::to_chars_result result = std::to_chars(begin, begin + NumberWidth, value);
+            position += static_cast<int>(result.ptr - begin);
+        } else {
+            std::ostringstream text;
+            text << value;
+            std::string formatted = text.str();
+            Put(formatted.data(), static_cast<int>(formatted.size()));
+        }
+    }
+
+    template <typename A, typename B>
+    void PutValue(const std::pair<A, B>& value) {
+        Put("(");
+        PutValue(value.first);
+        Put(", ");
+        PutValue(value.second);
+        Put(")");
+    }
+
+    // Печатает элементы [begin, end) одним проходом перечислителя
+    void WriteRange(const Sequence<T>& sequence, int begin, int end) {
+        int length = sequence.GetLength();
+        bool written = false;
+        Put(style.prefix);
+        if (begin > 0) {
+            Put(style.ellipsis);
+            written = true;
+        }
+        IEnumerator<T>* enumerator = sequence.GetEnumerator();
+        for (int i = 0; i < end && enumerator->MoveNext(); ++i) {
+            if (i >= begin) {
+                if (written) {
+                    Put(style.separator);
+                }
+                PutValue(enumerator->Current());
+                written = true;
+            }
+        }
+        delete enumerator;
+        if (end < length) {
+            if (written) {
+                Put(style.separator);
+            }
+            Put(style.ellipsis);
+        }
+        Put(style.suffix);
+    }
+
+public:
+    explicit SequenceFormatter(std::ostream& output, FormatStyle style = FormatStyle::Inline(),
+                               int bufferSize = 1 << 16)
+        : output(output), style(style), buffer(bufferSize < NumberWidth ? NumberWidth : bufferSize), position(0) {}
+
+    SequenceFormatter(const SequenceFormatter&) = delete;
+    SequenceFormatter& operator=(const SequenceFormatter&) = delete;
+
+    ~SequenceFormatter() {
+        Flush();
+    }
+
+    void Flush() {
+        if (position > 0) {
+            output.write(buffer.GetData(), position);
+            position = 0;
+        }
+    }
+
+    // Произвольный текст между последовательностями
+    void WriteText(const char* text) {
+        Put(text);
+    }
+
+    void Write(const Sequence<T>& sequence) {
+        WriteRange(sequence, 0, sequence.GetLength());
+    }
+
+    void WriteHead(const Sequence<T>& sequence, int count) {
+        if (count < 0) {
+            throw InvalidArgumentException("Count cannot be negative");
+        }
+        int length = sequence.GetLength();
+        WriteRange(sequence, 0, count < length ? count : length);
+    }
+
+    void WriteTail(const Sequence<T>& sequence, int count) {
+        if (count < 0) {
+            throw InvalidArgumentException("Count cannot be negative");
+        }
+        int length = sequence.GetLength();
+        WriteRange(sequence, count < length ? length - count : 0, length);
+    }
+
+    // count элементов через равные промежутки, включая первый и последний
+    void WriteSampled(const Sequence<T>& sequence, int count) {
+        if (count < 0) {
+            throw InvalidArgumentException("Count cannot be negative");
+        }
+        int length = sequence.GetLength();
+        if (count >= length) {
+            Write(sequence);
+            return;
+        }
+        Put(style.prefix);
+        if (count == 0) {
+            Put(style.ellipsis);
+            Put(style.suffix);
+            return;
+        }
+        IEnumerator<T>* enumerator = sequence.GetEnumerator();
+        int previous = -1;
+        int index = -1;
+        for (int k = 0; k < count; ++k) {
+            int target = count == 1 ? 0 : static_cast<int>(static_cast<long long>(k) * (length - 1) / (count - 1));
+            while (index < target && enumerator->MoveNext()) {
+                ++index;
+            }
+            if (k > 0) {
+                Put(style.separator);
+            }
+            if (target > previous + 1) {
+                Put(style.ellipsis);
+                Put(style.separator);
+            }
+            PutValue(enumerator->Current());
+            previous = target;
+        }
+        delete enumerator;
+        if (previous < length - 1) {
+            Put(style.separator);
+            Put(style.ellipsis);
+        }
+        Put(style.suffix);
+    }
+};
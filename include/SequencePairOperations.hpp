@@ -1,40 +1,206 @@
 #pragma once
 #include "Sequence.hpp"
+#include "ArraySequence.hpp"
 #include "ImmutableArraySequence.hpp"
 #include "ImmutableListSequence.hpp"
+#include "PairColumnSequence.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
 #include <utility>
 
+template<typename T, typename U>
+Sequence<std::pair<T, U>>* ParallelZip(const ArraySequence<T>& first, const ArraySequence<U>& second) {
+    int minLength = std::min(first.GetLength(), second.GetLength());
+    DynamicArray<std::pair<T, U>> pairs(minLength);
+    std::pair<T, U>* items = pairs.GetData();
+    const T* firstItems = first.GetData();
+    const U* secondItems = second.GetData();
+
+    int chunkCount = ParallelChunkCount(minLength);
+    ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+        int begin, end;
+        GetChunkRange(minLength, chunkCount, chunk, begin, end);
+        for (int i = begin; i < end; ++i) {
+            items[i].first = firstItems[i];
+            items[i].second = secondItems[i];
+        }
+    });
+    return new ImmutableArraySequence<std::pair<T, U>>(std::move(pairs));
+}
+
+// Массивы обрабатываются параллельно, остальные последовательности — одним проходом
+// перечислителей сразу в итоговое хранилище.
 template<typename T, typename U>
 Sequence<std::pair<T, U>>* Zip(const Sequence<T>& first, const Sequence<U>& second) {
+    auto* firstArray = dynamic_cast<const ArraySequence<T>*>(&first);
+    auto* secondArray = dynamic_cast<const ArraySequence<U>*>(&second);
+    if (firstArray && secondArray) {
+        return ParallelZip(*firstArray, *secondArray);
+    }
+
     int minLength = std::min(first.GetLength(), second.GetLength());
-    std::pair<T, U>* pairs = new std::pair<T, U>[minLength];
-    
-    for (int i = 0; i < minLength; ++i) {
-        pairs[i] = std::make_pair(first.Get(i), second.Get(i));
-    }
-    
-    auto* result = new ImmutableArraySequence<std::pair<T, U>>(pairs, minLength);
-    delete[] pairs;
-    return result;
+    DynamicArray<std::pair<T, U>> pairs(minLength);
+    std::pair<T, U>* items = pairs.GetData();
+
+    IEnumerator<T>* firstEnumerator = first.GetEnumerator();
+    IEnumerator<U>* secondEnumerator = second.GetEnumerator();
+    for (int i = 0; i < minLength && firstEnumerator->MoveNext() && secondEnumerator->MoveNext(); ++i) {
+        items[i].first = firstEnumerator->Current();
+        items[i].second = secondEnumerator->Current();
+    }
+    delete firstEnumerator;
+    delete secondEnumerator;
+
+    return new ImmutableArraySequence<std::pair<T, U>>(std::move(pairs));
+}
+
+// Zip в столбцовое хранилище: два массовых копирования вместо поэлементной сборки пар
+template<typename T, typename U>
+PairColumnSequence<T, U>* ZipColumns(const ArraySequence<T>& first, const ArraySequence<U>& second) {
+    int minLength = std::min(first.GetLength(), second.GetLength());
+    DynamicArray<T> firstColumn(first.GetData(), minLength);
+    DynamicArray<U> secondColumn(second.GetData(), minLength);
+    return new PairColumnSequence<T, U>(std::move(firstColumn), std::move(secondColumn));
+}
+
+template<typename T, typename U>
+std::pair<Sequence<T>*, Sequence<U>*> ParallelUnzip(const ArraySequence<std::pair<T, U>>& sequence) {
+    int length = sequence.GetLength();
+    DynamicArray<T> firstColumn(length);
+    DynamicArray<U> secondColumn(length);
+    T* firstItems = firstColumn.GetData();
+    U* secondItems = secondColumn.GetData();
+    const std::pair<T, U>* pairs = sequence.GetData();
+
+    int chunkCount = ParallelChunkCount(length);
+    ThreadPool::Instance().ParallelFor(chunkCount, [&](int chunk) {
+        int begin, end;
+        GetChunkRange(length, chunkCount, chunk, begin, end);
+        for (int i = begin; i < end; ++i) {
+            firstItems[i] = pairs[i].first;
+            secondItems[i] = pairs[i].second;
+        }
+    });
+
+    Sequence<T>* firstSeq = new ImmutableArraySequence<T>(std::move(firstColumn));
+    Sequence<U>* secondSeq = new ImmutableArraySequence<U>(std::move(secondColumn));
+    return std::make_pair(firstSeq, secondSeq);
 }
 
 template<typename T, typename U>
 std::pair<Sequence<T>*, Sequence<U>*> Unzip(const Sequence<std::pair<T, U>>& sequence) {
+    auto* array = dynamic_cast<const ArraySequence<std::pair<T, U>>*>(&sequence);
+    if (array) {
+        return ParallelUnzip(*array);
+    }
+    auto* columns = dynamic_cast<const PairColumnSequence<T, U>*>(&sequence);
+    if (columns) {
+        Sequence<T>* firstSeq = new ImmutableArraySequence<T>(columns->GetFirstColumn());
+        Sequence<U>* secondSeq = new ImmutableArraySequence<U>(columns->GetSecondColumn());
+        return std::make_pair(firstSeq, secondSeq);
+    }
+
     int length = sequence.GetLength();
-    T* firstItems = new T[length];
-    U* secondItems = new U[length];
-    
-    for (int i = 0; i < length; ++i) {
-        const auto& pair = sequence.Get(i);
+    DynamicArray<T> firstColumn(length);
+    DynamicArray<U> secondColumn(length);
+    T* firstItems = firstColumn.GetData();
+    U* secondItems = secondColumn.GetData();
+
+    IEnumerator<std::pair<T, U>>* enumerator = sequence.GetEnumerator();
+    for (int i = 0; i < length && enumerator->MoveNext(); ++i) {
+        const std::pair<T, U>& pair = enumerator->Current();
         firstItems[i] = pair.first;
         secondItems[i] = pair.second;
     }
-    
-    auto* firstSeq = new ImmutableArraySequence<T>(firstItems, length);
-    auto* secondSeq = new ImmutableArraySequence<U>(secondItems, length);
-    
-    delete[] firstItems;
-    delete[] secondItems;
-    
+    delete enumerator;
+
+    Sequence<T>* firstSeq = new ImmutableArraySequence<T>(std::move(firstColumn));
+    Sequence<U>* secondSeq = new ImmutableArraySequence<U>(std::move(secondColumn));
+    return std::make_pair(firstSeq, secondSeq);
+}
+
+// Столбцы временной последовательности забираются без копирования, за O(1)
+template<typename T, typename U>
+std::pair<Sequence<T>*, Sequence<U>*> Unzip(PairColumnSequence<T, U>&& sequence) {
+    std::pair<DynamicArray<T>, DynamicArray<U>> columns = sequence.ReleaseColumns();
+    Sequence<T>* firstSeq = new ImmutableArraySequence<T>(std::move(columns.first));
+    Sequence<U>* secondSeq = new ImmutableArraySequence<U>(std::move(columns.second));
     return std::make_pair(firstSeq, secondSeq);
-} 
\ No newline at end of file
+}
+
+// Ленивое представление Zip: пары строятся по одной при обращении и нигде не хранятся.
+// Исходные последовательности должны жить дольше представления.
+template<typename T, typename U>
+class ZipView : public IEnumerable<std::pair<T, U>> {
+private:
+    const Sequence<T>& first;
+    const Sequence<U>& second;
+
+    // Число пар известно заранее, поэтому более длинная последовательность не
+    // продвигается за конец более короткой
+    class ZipEnumerator : public IEnumerator<std::pair<T, U>> {
+    private:
+        IEnumerator<T>* firstEnumerator;
+        IEnumerator<U>* secondEnumerator;
+        std::pair<T, U> currentPair;
+        int length;
+        int position;
+        bool hasCurrent;
+
+    public:
+        ZipEnumerator(IEnumerator<T>* firstEnumerator, IEnumerator<U>* secondEnumerator, int length)
+            : firstEnumerator(firstEnumerator), secondEnumerator(secondEnumerator), length(length), position(0),
+              hasCurrent(false) {}
+
+        ~ZipEnumerator() override {
+            delete firstEnumerator;
+            delete secondEnumerator;
+        }
+
+        bool MoveNext() override {
+            if (position < length && firstEnumerator->MoveNext() && secondEnumerator->MoveNext()) {
+                currentPair.first = firstEnumerator->Current();
+                currentPair.second = secondEnumerator->Current();
+                ++position;
+                hasCurrent = true;
+                return true;
+            }
+            position = length;
+            hasCurrent = false;
+            return false;
+        }
+
+        const std::pair<T, U>& Current() const override {
+            if (!hasCurrent) {
+                throw InvalidStateException("Enumerator is not in a valid position");
+            }
+            return currentPair;
+        }
+
+        void Reset() override {
+            firstEnumerator->Reset();
+            secondEnumerator->Reset();
+            position = 0;
+            hasCurrent = false;
+        }
+    };
+
+public:
+    ZipView(const Sequence<T>& first, const Sequence<U>& second) : first(first), second(second) {}
+
+    int GetLength() const {
+        return std::min(first.GetLength(), second.GetLength());
+    }
+
+    std::pair<T, U> Get(int index) const {
+        if (index < 0 || index >= GetLength()) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        return std::make_pair(first.Get(index), second.Get(index));
+    }
+
+    IEnumerator<std::pair<T, U>>* GetEnumerator() const override {
+        SEQUENCE_COUNT(EnumeratorAllocations, 1);
+        return new ZipEnumerator(first.GetEnumerator(), second.GetEnumerator(), GetLength());
+    }
+};
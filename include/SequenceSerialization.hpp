@@ -0,0 +1,474 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "Sequence.hpp"
+#include "DynamicArray.hpp"
+#include "LinkedList.hpp"
+#include "SequenceSink.hpp"
+#include "ArraySequence.hpp"
+#include "ListSequence.hpp"
+#include "ImmutableArraySequence.hpp"
+#include "ImmutableListSequence.hpp"
+#include "Exceptions.hpp"
+
+// Двоичный формат последовательности: заголовок 32 байта, затем элементы подряд.
+// Поля заголовка пишутся в порядке байт машины.
+struct SequenceFileHeader {
+    char magic[4];             // "SEQB"
+    std::uint16_t version;
+    std::uint16_t flags;       // RawPayload — элементы записаны байтами как есть
+    std::uint32_t typeTag;     // SequenceCodec<T>::TypeTag
+    std::uint32_t elementSize; // sizeof(T) для RawPayload, иначе 0
+    std::int64_t length;
+    std::uint64_t checksum;    // SequenceChecksum по всем байтам после заголовка
+
+    static constexpr std::uint16_t CurrentVersion = 1;
+    static constexpr std::uint16_t RawPayload = 1;
+};
+
+static_assert(sizeof(SequenceFileHeader) == 32, "SequenceFileHeader must stay 32 bytes");
+
+// Контрольная сумма FNV-1a по 64-битным словам, хвост — побайтно.
+// Слова собираются через буфер, поэтому результат не зависит от того, какими кусками
+// пришли данные.
+class SequenceChecksum {
+private:
+    static constexpr std::uint64_t Offset = 14695981039346656037ULL;
+    static constexpr std::uint64_t Prime = 1099511628211ULL;
+
+    std::uint64_t state;
+    unsigned char pending[8];
+    int pendingCount;
+
+    void Mix(std::uint64_t word) {
+        state = (state ^ word) * Prime;
+    }
+
+public:
+    SequenceChecksum() : state(Offset), pendingCount(0) {}
+
+    void Update(const void* data, std::size_t size) {
+        // Пустой кусок может прийти с нулевым указателем, а memcpy его не допускает
+        if (size == 0) {
+            return;
+        }
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        // Копии с явной границей: компилятор видит, что pending не переполняется
+        if (pendingCount > 0) {
+            std::size_t take = std::min<std::size_t>(8 - pendingCount, size);
+            std::memcpy(pending + pendingCount, bytes, take);
+            pendingCount += static_cast<int>(take);
+            bytes += take;
+            size -= take;
+            if (pendingCount < 8) {
+                return;
+            }
+            std::uint64_t word;
+            std::memcpy(&word, pending, 8);
+            Mix(word);
+            pendingCount = 0;
+        }
+        for (; size >= 8; size -= 8, bytes += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes, 8);
+            Mix(word);
+        }
+        // Здесь pendingCount == 0 и size < 8
+        std::memcpy(pending, bytes, size);
+        pendingCount = static_cast<int>(size);
+    }
+
+    std::uint64_t Finish() const {
+        std::uint64_t result = state;
+        for (int i = 0; i < pendingCount; ++i) {
+            result = (result ^ pending[i]) * Prime;
+        }
+        return result;
+    }
+};
+
+// Буферизованная запись с подсчётом контрольной суммы. Без потока только считает сумму —
+// первый проход для последовательностей, которые нельзя отдать одним куском.
+class SequenceByteWriter {
+private:
+    std::ostream* output;
+    DynamicArray<char> buffer;
+    int position;
+    SequenceChecksum checksum;
+
+public:
+    explicit SequenceByteWriter(std::ostream* output, int bufferSize = 1 << 16)
+        : output(output), buffer(output ? bufferSize : 0), position(0) {}
+
+    void Write(const void* data, std::size_t size) {
+        checksum.Update(data, size);
+        if (!output) {
+            return;
+        }
+        if (position + size > static_cast<std::size_t>(buffer.GetSize())) {
+            Flush();
+            if (size >= static_cast<std::size_t>(buffer.GetSize())) {
+                output->write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+                return;
+            }
+        }
+        std::memcpy(buffer.GetData() + position, data, size);
+        position += static_cast<int>(size);
+    }
+
+    void Flush() {
+        if (output && position > 0) {
+            output->write(buffer.GetData(), position);
+            position = 0;
+        }
+    }
+
+    std::uint64_t GetChecksum() const {
+        return checksum.Finish();
+    }
+};
+
+// Буферизованное чтение с подсчётом контрольной суммы
+class SequenceByteReader {
+private:
+    std::istream& input;
+    DynamicArray<char> buffer;
+    int position;
+    int available;
+    long long total;
+    long long consumed;
+    SequenceChecksum checksum;
+
+    // Байт до конца потока или -1, если поток не поддерживает позиционирование
+    static long long StreamRemaining(std::istream& input) {
+        std::streambuf* source = input.rdbuf();
+        std::streampos current = source->pubseekoff(0, std::ios::cur, std::ios::in);
+        if (current == std::streampos(-1)) {
+            return -1;
+        }
+        std::streampos end = source->pubseekoff(0, std::ios::end, std::ios::in);
+        source->pubseekpos(current, std::ios::in);
+        return end == std::streampos(-1) ? -1 : static_cast<long long>(end - current);
+    }
+
+public:
+    explicit SequenceByteReader(std::istream& input, int bufferSize = 1 << 16)
+        : input(input), buffer(bufferSize), position(0), available(0),
+          total(StreamRemaining(input)), consumed(0) {}
+
+    // Сколько байт ещё можно прочитать; -1 — неизвестно
+    long long GetRemaining() const {
+        return total < 0 ? -1 : total - consumed;
+    }
+
+    void Read(void* data, std::size_t size) {
+        char* target = static_cast<char*>(data);
+        std::size_t remaining = size;
+        while (remaining > 0) {
+            if (position == available) {
+                // Большие блоки читаются сразу в место назначения
+                if (remaining >= static_cast<std::size_t>(buffer.GetSize())) {
+                    std::streamsize got = input.rdbuf()->sgetn(target, static_cast<std::streamsize>(remaining));
+                    if (got <= 0) {
+                        throw SerializationException("Unexpected end of sequence data");
+                    }
+                    target += got;
+                    remaining -= static_cast<std::size_t>(got);
+                    continue;
+                }
+                available = static_cast<int>(input.rdbuf()->sgetn(buffer.GetData(), buffer.GetSize()));
+                position = 0;
+                if (available <= 0) {
+                    available = 0;
+                    throw SerializationException("Unexpected end of sequence data");
+                }
+            }
+            std::size_t chunk = static_cast<std::size_t>(available - position);
+            if (chunk > remaining) {
+                chunk = remaining;
+            }
+            std::memcpy(target, buffer.GetData() + position, chunk);
+            position += static_cast<int>(chunk);
+            target += chunk;
+            remaining -= chunk;
+        }
+        consumed += static_cast<long long>(size);
+        checksum.Update(data, size);
+    }
+
+    std::uint64_t GetChecksum() const {
+        return checksum.Finish();
+    }
+};
+
+const std::uint32_t OpaqueTypeTag = 0xFFFF;
+
+// Теги встроенных типов; для своих тривиально копируемых типов — OpaqueTypeTag
+// (проверяется только размер элемента)
+template <typename T>
+constexpr std::uint32_t GetSerializationTypeTag() {
+    return std::is_same<T, bool>::value ? 1
+           : std::is_same<T, char>::value ? 2
+           : std::is_same<T, signed char>::value ? 3
+           : std::is_same<T, unsigned char>::value ? 4
+           : std::is_same<T, short>::value ? 5
+           : std::is_same<T, unsigned short>::value ? 6
+           : std::is_same<T, int>::value ? 7
+           : std::is_same<T, unsigned>::value ? 8
+           : std::is_same<T, long>::value ? 9
+           : std::is_same<T, unsigned long>::value ? 10
+           : std::is_same<T, long long>::value ? 11
+           : std::is_same<T, unsigned long long>::value ? 12
+           : std::is_same<T, float>::value ? 13
+           : std::is_same<T, double>::value ? 14
+           : std::is_same<T, long double>::value ? 15
+           : OpaqueTypeTag;
+}
+
+// Кодек элементов. Тривиально копируемые типы пишутся байтами как есть (IsRaw),
+// для остальных нужна специализация с TypeTag, MinEncodedSize, Write и Read — см.
+// std::string ниже.
+template <typename T, typename Enable = void>
+struct SequenceCodec {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Specialize SequenceCodec for element types that are not trivially copyable");
+    static constexpr bool IsRaw = true;
+    static constexpr std::uint32_t TypeTag = GetSerializationTypeTag<T>();
+    static constexpr std::size_t MinEncodedSize = sizeof(T);
+};
+
+template <>
+struct SequenceCodec<std::string> {
+    static constexpr bool IsRaw = false;
+    static constexpr std::uint32_t TypeTag = 0x100;
+
+    static void Write(const std::string& value, SequenceByteWriter& writer) {
+        std::uint32_t size = static_cast<std::uint32_t>(value.size());
+        writer.Write(&size, sizeof(size));
+        writer.Write(value.data(), value.size());
+    }
+
+    // Наименьший размер записи одного элемента — префикс длины
+    static constexpr std::size_t MinEncodedSize = sizeof(std::uint32_t);
+
+    // Длине из файла не доверяем: она сверяется с остатком потока, а если он
+    // неизвестен, строка растёт кусками по мере чтения
+    static std::string Read(SequenceByteReader& reader) {
+        std::uint32_t size = 0;
+        reader.Read(&size, sizeof(size));
+        long long remaining = reader.GetRemaining();
+        if (remaining >= 0 && size > remaining) {
+            throw SerializationException("String length exceeds remaining data");
+        }
+        const std::size_t chunkSize = 1 << 16;
+        std::string value;
+        while (value.size() < size) {
+            std::size_t done = value.size();
+            std::size_t chunk = size - done < chunkSize ? size - done : chunkSize;
+            value.resize(done + chunk);
+            reader.Read(&value[done], chunk);
+        }
+        return value;
+    }
+};
+
+// Сохранение и загрузка последовательностей в двоичном формате. Для тривиально
+// копируемых элементов содержимое ArraySequence уходит одной записью, а загрузка
+// в массив — одним чтением прямо в хранилище DynamicArray.
+template <typename T>
+class SequenceSerializer {
+private:
+    using Codec = SequenceCodec<T>;
+
+    static constexpr int ChunkSize = 4096;
+
+    static const T* GetContiguousData(const Sequence<T>& sequence) {
+        const ArraySequence<T>* array = dynamic_cast<const ArraySequence<T>*>(&sequence);
+        return array ? array->GetData() : nullptr;
+    }
+
+    // Проход по элементам через перечислитель; writer без потока только считает сумму
+    static void WriteElements(const Sequence<T>& sequence, SequenceByteWriter& writer) {
+        IEnumerator<T>* enumerator = sequence.GetEnumerator();
+        if constexpr (Codec::IsRaw) {
+            DynamicArray<T> chunk(ChunkSize);
+            int filled = 0;
+            while (enumerator->MoveNext()) {
+                chunk[filled++] = enumerator->Current();
+                if (filled == ChunkSize) {
+                    writer.Write(chunk.GetData(), sizeof(T) * filled);
+                    filled = 0;
+                }
+            }
+            writer.Write(chunk.GetData(), sizeof(T) * filled);
+        } else {
+            while (enumerator->MoveNext()) {
+                Codec::Write(enumerator->Current(), writer);
+            }
+        }
+        delete enumerator;
+    }
+
+    static SequenceFileHeader ReadHeader(std::istream& input) {
+        SequenceFileHeader header;
+        if (input.rdbuf()->sgetn(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)) {
+            throw SerializationException("Truncated sequence header");
+        }
+        ValidateHeader(header);
+        return header;
+    }
+
+    static void ReadElements(SequenceByteReader& reader, T* items, int count) {
+        if constexpr (Codec::IsRaw) {
+            reader.Read(items, sizeof(T) * static_cast<std::size_t>(count));
+        } else {
+            for (int i = 0; i < count; ++i) {
+                items[i] = Codec::Read(reader);
+            }
+        }
+    }
+
+    static void VerifyChecksum(const SequenceFileHeader& header, std::uint64_t actual) {
+        if (header.checksum != actual) {
+            throw SerializationException("Sequence checksum mismatch: data is corrupted");
+        }
+    }
+
+public:
+    // Проверяет заголовок на соответствие типу T
+    static void ValidateHeader(const SequenceFileHeader& header) {
+        if (std::memcmp(header.magic, "SEQB", 4) != 0) {
+            throw SerializationException("Not a sequence file: bad magic");
+        }
+        if (header.version != SequenceFileHeader::CurrentVersion) {
+            throw SerializationException("Unsupported sequence format version " + std::to_string(header.version));
+        }
+        std::uint16_t expectedFlags = Codec::IsRaw ? SequenceFileHeader::RawPayload : 0;
+        std::uint32_t expectedSize = Codec::IsRaw ? static_cast<std::uint32_t>(sizeof(T)) : 0;
+        if (header.typeTag != Codec::TypeTag || header.flags != expectedFlags || header.elementSize != expectedSize) {
+            throw SerializationException("Element type mismatch: file has type tag " + std::to_string(header.typeTag) +
+                                         ", element size " + std::to_string(header.elementSize));
+        }
+        if (header.length < 0 || header.length > INT_MAX) {
+            throw SerializationException("Invalid sequence length " + std::to_string(header.length));
+        }
+    }
+
+    static void Save(const Sequence<T>& sequence, std::ostream& output) {
+        SequenceFileHeader header;
+        std::memcpy(header.magic, "SEQB", 4);
+        header.version = SequenceFileHeader::CurrentVersion;
+        header.flags = Codec::IsRaw ? SequenceFileHeader::RawPayload : 0;
+        header.typeTag = Codec::TypeTag;
+        header.elementSize = Codec::IsRaw ? static_cast<std::uint32_t>(sizeof(T)) : 0;
+        header.length = sequence.GetLength();
+
+        const T* data = nullptr;
+        if constexpr (Codec::IsRaw) {
+            data = GetContiguousData(sequence);
+        }
+        if (data) {
+            std::size_t bytes = sizeof(T) * static_cast<std::size_t>(header.length);
+            SequenceChecksum checksum;
+            checksum.Update(data, bytes);
+            header.checksum = checksum.Finish();
+            output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            output.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        } else {
+            // Сумма нужна в заголовке до данных: первый проход только считает её
+            SequenceByteWriter counter(nullptr);
+            WriteElements(sequence, counter);
+            header.checksum = counter.GetChecksum();
+            output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            SequenceByteWriter writer(&output);
+            WriteElements(sequence, writer);
+            writer.Flush();
+        }
+        if (!output) {
+            throw SerializationException("Failed to write sequence data");
+        }
+    }
+
+    // Загрузка сразу в хранилище массива, без поэлементного Append
+    // Длина из заголовка сверяется с остатком потока до выделения памяти. Если
+    // остаток неизвестен (поток без позиционирования), массив растёт вдвое по мере
+    // чтения — повреждённый заголовок не приводит к огромному выделению.
+    static DynamicArray<T> LoadItems(std::istream& input) {
+        SequenceFileHeader header = ReadHeader(input);
+        int length = static_cast<int>(header.length);
+        SequenceByteReader reader(input);
+        long long remaining = reader.GetRemaining();
+        if (remaining >= 0 && remaining / static_cast<long long>(Codec::MinEncodedSize) < length) {
+            throw SerializationException("Sequence length exceeds remaining data");
+        }
+
+        DynamicArray<T> items;
+        if (remaining >= 0) {
+            items = DynamicArray<T>(length);
+            ReadElements(reader, items.GetData(), length);
+        } else {
+            for (int done = 0; done < length;) {
+                int step = done > ChunkSize ? done : ChunkSize;
+                int count = length - done < step ? length - done : step;
+                items.Resize(done + count);
+                ReadElements(reader, items.GetData() + done, count);
+                done += count;
+            }
+        }
+        VerifyChecksum(header, reader.GetChecksum());
+        return items;
+    }
+
+    // Передаёт элементы в sink по мере чтения; сумма проверяется в конце,
+    // поэтому при повреждённых данных sink уже получит часть элементов
+    static void LoadInto(std::istream& input, ISequenceSink<T>& sink) {
+        SequenceFileHeader header = ReadHeader(input);
+        int length = static_cast<int>(header.length);
+        SequenceByteReader reader(input);
+        if constexpr (Codec::IsRaw) {
+            DynamicArray<T> chunk(length < ChunkSize ? length : ChunkSize);
+            for (int done = 0; done < length; done += chunk.GetSize()) {
+                int count = length - done < chunk.GetSize() ? length - done : chunk.GetSize();
+                reader.Read(chunk.GetData(), sizeof(T) * count);
+                for (int i = 0; i < count; ++i) {
+                    sink.Push(chunk[i]);
+                }
+            }
+        } else {
+            for (int i = 0; i < length; ++i) {
+                sink.Push(Codec::Read(reader));
+            }
+        }
+        VerifyChecksum(header, reader.GetChecksum());
+    }
+
+    static ArraySequence<T>* LoadArraySequence(std::istream& input) {
+        return new ArraySequence<T>(LoadItems(input));
+    }
+
+    static ImmutableArraySequence<T>* LoadImmutableArraySequence(std::istream& input) {
+        return new ImmutableArraySequence<T>(LoadItems(input));
+    }
+
+    static ListSequence<T>* LoadListSequence(std::istream& input) {
+        LinkedList<T> items;
+        LinkedListSink<T> sink(items);
+        LoadInto(input, sink);
+        return new ListSequence<T>(std::move(items));
+    }
+
+    static ImmutableListSequence<T>* LoadImmutableListSequence(std::istream& input) {
+        LinkedList<T> items;
+        LinkedListSink<T> sink(items);
+        LoadInto(input, sink);
+        return new ImmutableListSequence<T>(std::move(items));
+    }
+};
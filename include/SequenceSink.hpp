@@ -0,0 +1,87 @@
+#pragma once
+#include "DynamicArray.hpp"
+#include "LinkedList.hpp"
+#include "Exceptions.hpp"
+
+// Приёмник элементов: функция FlatMap пишет в него результат вместо
+// создания промежуточной последовательности в куче.
+template<typename T>
+class ISequenceSink {
+public:
+    virtual ~ISequenceSink() = default;
+    virtual void Push(const T& item) = 0;
+};
+
+// Только считает элементы — первая фаза параллельного FlatMap.
+template<typename T>
+class CountingSink : public ISequenceSink<T> {
+private:
+    long long count;
+
+public:
+    CountingSink() : count(0) {}
+
+    void Push(const T&) override {
+        ++count;
+    }
+
+    long long GetCount() const {
+        return count;
+    }
+};
+
+// Пишет в заранее выделенный участок буфера фиксированного размера.
+template<typename T>
+class BufferSink : public ISequenceSink<T> {
+private:
+    T* items;
+    int capacity;
+    int written;
+
+public:
+    BufferSink(T* items, int capacity) : items(items), capacity(capacity), written(0) {}
+
+    void Push(const T& item) override {
+        if (written >= capacity) {
+            throw InvalidStateException("Sink capacity exceeded: function produced a different number of elements");
+        }
+        items[written++] = item;
+    }
+
+    int GetWritten() const {
+        return written;
+    }
+};
+
+// Дописывает в конец DynamicArray с геометрическим ростом ёмкости.
+template<typename T>
+class DynamicArraySink : public ISequenceSink<T> {
+private:
+    DynamicArray<T>& array;
+
+public:
+    explicit DynamicArraySink(DynamicArray<T>& array) : array(array) {}
+
+    void Push(const T& item) override {
+        int oldSize = array.GetSize();
+        if (oldSize == array.GetCapacity()) {
+            array.Reserve(oldSize < 8 ? 8 : oldSize * 2);
+        }
+        array.Resize(oldSize + 1);
+        array.GetData()[oldSize] = item;
+    }
+};
+
+// Дописывает в конец LinkedList (O(1) через указатель на хвост).
+template<typename T>
+class LinkedListSink : public ISequenceSink<T> {
+private:
+    LinkedList<T>& list;
+
+public:
+    explicit LinkedListSink(LinkedList<T>& list) : list(list) {}
+
+    void Push(const T& item) override {
+        list.Append(item);
+    }
+};
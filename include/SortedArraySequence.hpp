@@ -0,0 +1,351 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include "ReadOnlySequence.hpp"
+#include "DynamicArray.hpp"
+#include "SequenceSink.hpp"
+#include "Exceptions.hpp"
+
+// Раскладка для двоичного поиска: обычный отсортированный массив или копия в
+// порядке Эйтцингера (обход дерева в ширину, корень в ячейке 1). Во втором случае
+// спуск идёт без ветвлений, а потомки следующих уровней лежат рядом и
+// подкачиваются заранее.
+enum class SearchLayout {
+    Sorted,
+    Eytzinger
+};
+
+// Массив, который всегда упорядочен по compare. Add вставляет на своё место,
+// Append/Prepend/InsertAt допускают только элементы, не нарушающие порядок.
+// Поиск значений — за O(log n); Find с произвольным предикатом остаётся линейным.
+// Копия Эйтцингера перестраивается сразу в SetSearchLayout и после каждого
+// изменения, а не при первом поиске: поиски ничего не пишут, и одновременное
+// чтение из нескольких потоков безопасно. Пачку вставок выгоднее делать через Merge.
+template <typename T, typename Compare = std::less<T>>
+class SortedArraySequence : public ReadOnlySequence<T> {
+private:
+    struct SortedTag {};
+
+    DynamicArray<T> array;
+    Compare compare;
+    SearchLayout layout;
+    DynamicArray<T> eytzinger;
+    DynamicArray<int> ranks;
+
+    // Уже упорядоченные данные: сортировка не нужна
+    SortedArraySequence(SortedTag, DynamicArray<T>&& sorted, Compare compare, SearchLayout layout)
+        : array(std::move(sorted)), compare(compare), layout(layout) {
+        BuildLayout();
+    }
+
+    void SortAll() {
+        std::sort(array.GetData(), array.GetData() + array.GetSize(), compare);
+    }
+
+    void ReserveFor(int count) {
+        if (count > array.GetCapacity()) {
+            int doubled = array.GetCapacity() * 2;
+            array.Reserve(count > doubled ? count : (doubled < 8 ? 8 : doubled));
+        }
+    }
+
+    void InsertChecked(const T& item, int index) {
+        int size = array.GetSize();
+        ReserveFor(size + 1);
+        array.Resize(size + 1);
+        T* items = array.GetData();
+        for (int i = size; i > index; --i) {
+            items[i] = std::move(items[i - 1]);
+        }
+        items[index] = item;
+        BuildLayout();
+    }
+
+    // Симметричный обход дерева раскладывает отсортированные элементы по узлам
+    int FillEytzinger(int sortedIndex, int node) {
+        int size = array.GetSize();
+        if (node <= size) {
+            sortedIndex = FillEytzinger(sortedIndex, 2 * node);
+            eytzinger[node] = array.GetData()[sortedIndex];
+            ranks[node] = sortedIndex;
+            sortedIndex = FillEytzinger(sortedIndex + 1, 2 * node + 1);
+        }
+        return sortedIndex;
+    }
+
+    // Приводит копию для поиска в соответствие с массивом и текущей раскладкой
+    void BuildLayout() {
+        if (layout != SearchLayout::Eytzinger) {
+            eytzinger = DynamicArray<T>();
+            ranks = DynamicArray<int>();
+            return;
+        }
+        int size = array.GetSize();
+        eytzinger = DynamicArray<T>(size + 1);
+        ranks = DynamicArray<int>(size + 1);
+        FillEytzinger(0, 1);
+    }
+
+    // Спуск по дереву: на каждом уровне узел k уходит в 2k или 2k + 1 по результату
+    // сравнения. Остановившись за листом, снимаем хвост из правых поворотов и
+    // последний левый — получаем узел ответа. Ответ n кодируется узлом 0.
+    template <typename GoRight>
+    int EytzingerSearch(GoRight goRight) const {
+        int size = array.GetSize();
+        const T* tree = eytzinger.GetData();
+        int node = 1;
+        while (node <= size) {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(tree + static_cast<long long>(node) * PrefetchStride);
+#endif
+            node = 2 * node + (goRight(tree[node]) ? 1 : 0);
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        node >>= __builtin_ffs(~node);
+#else
+        while (node & 1) {
+            node >>= 1;
+        }
+        node >>= 1;
+#endif
+        return node == 0 ? size : ranks.GetData()[node];
+    }
+
+public:
+    // Через PrefetchStride уровней вниз потомки узла k занимают одну строку кэша
+    static constexpr int PrefetchStride = sizeof(T) >= 64 ? 1 : 64 / static_cast<int>(sizeof(T));
+
+    explicit SortedArraySequence(Compare compare = Compare())
+        : compare(compare), layout(SearchLayout::Sorted) {}
+
+    SortedArraySequence(const T* items, int count, Compare compare = Compare())
+        : array(items, count), compare(compare), layout(SearchLayout::Sorted) {
+        SortAll();
+    }
+
+    explicit SortedArraySequence(const DynamicArray<T>& items, Compare compare = Compare())
+        : array(items), compare(compare), layout(SearchLayout::Sorted) {
+        SortAll();
+    }
+
+    explicit SortedArraySequence(const Sequence<T>& source, Compare compare = Compare())
+        : compare(compare), layout(SearchLayout::Sorted) {
+        DynamicArraySink<T> sink(array);
+        IEnumerator<T>* enumerator = source.GetEnumerator();
+        while (enumerator->MoveNext()) {
+            sink.Push(enumerator->Current());
+        }
+        delete enumerator;
+        SortAll();
+    }
+
+    SortedArraySequence(const SortedArraySequence<T, Compare>& other)
+        : array(other.array), compare(other.compare), layout(other.layout), eytzinger(other.eytzinger),
+          ranks(other.ranks) {}
+
+    void SetSearchLayout(SearchLayout newLayout) {
+        if (newLayout != layout) {
+            layout = newLayout;
+            BuildLayout();
+        }
+    }
+
+    SearchLayout GetSearchLayout() const {
+        return layout;
+    }
+
+    T Get(int index) const override {
+        if (index < 0 || index >= array.GetSize()) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+        return array.GetData()[index];
+    }
+
+    int GetLength() const override {
+        return array.GetSize();
+    }
+
+    const T* GetData() const {
+        return array.GetData();
+    }
+
+    // Индекс первого элемента, не меньшего value (или длина)
+    int LowerBound(const T& value) const {
+        if (layout == SearchLayout::Eytzinger) {
+            return EytzingerSearch([&](const T& item) { return compare(item, value); });
+        }
+        const T* items = array.GetData();
+        return static_cast<int>(std::lower_bound(items, items + array.GetSize(), value, compare) - items);
+    }
+
+    // Индекс первого элемента, большего value (или длина)
+    int UpperBound(const T& value) const {
+        if (layout == SearchLayout::Eytzinger) {
+            return EytzingerSearch([&](const T& item) { return !compare(value, item); });
+        }
+        const T* items = array.GetData();
+        return static_cast<int>(std::upper_bound(items, items + array.GetSize(), value, compare) - items);
+    }
+
+    // Полуинтервал [first, second) элементов, эквивалентных value
+    std::pair<int, int> EqualRange(const T& value) const {
+        return std::make_pair(LowerBound(value), UpperBound(value));
+    }
+
+    bool Contains(const T& value) const {
+        int index = LowerBound(value);
+        return index < array.GetSize() && !compare(value, array.GetData()[index]);
+    }
+
+    // Число элементов в отрезке [low, high]
+    int CountInRange(const T& low, const T& high) const {
+        if (compare(high, low)) {
+            return 0;
+        }
+        return UpperBound(high) - LowerBound(low);
+    }
+
+    // Как у ArraySequence, не перегрузка Find: литерал 0 неоднозначен между T и предикатом
+    Option<T> FindValue(const T& value) const {
+        int index = LowerBound(value);
+        if (index < array.GetSize() && !compare(value, array.GetData()[index])) {
+            return Option<T>::Some(array.GetData()[index]);
+        }
+        return Option<T>::None();
+    }
+
+    // Вставляет после равных элементов; возвращает позицию вставки
+    int Add(const T& item) {
+        int position = UpperBound(item);
+        InsertChecked(item, position);
+        return position;
+    }
+
+    // Удаляет один элемент, эквивалентный value
+    bool Remove(const T& value) {
+        int size = array.GetSize();
+        int position = LowerBound(value);
+        T* items = array.GetData();
+        if (position == size || compare(value, items[position])) {
+            return false;
+        }
+        for (int i = position + 1; i < size; ++i) {
+            items[i - 1] = std::move(items[i]);
+        }
+        array.Resize(size - 1);
+        BuildLayout();
+        return true;
+    }
+
+    // Слияние с неупорядоченной пачкой: пачка сортируется отдельно (k log k), затем
+    // обе части сливаются с конца на месте за O(n + k)
+    void Merge(const T* items, int count) {
+        if (count <= 0) {
+            return;
+        }
+        DynamicArray<T> batch(items, count);
+        std::sort(batch.GetData(), batch.GetData() + count, compare);
+
+        int size = array.GetSize();
+        ReserveFor(size + count);
+        array.Resize(size + count);
+        T* target = array.GetData();
+        const T* incoming = batch.GetData();
+        int i = size - 1;
+        int j = count - 1;
+        for (int out = size + count - 1; j >= 0; --out) {
+            if (i >= 0 && compare(incoming[j], target[i])) {
+                target[out] = std::move(target[i--]);
+            } else {
+                target[out] = incoming[j--];
+            }
+        }
+        BuildLayout();
+    }
+
+    void Merge(const Sequence<T>& batch) {
+        DynamicArray<T> items;
+        DynamicArraySink<T> sink(items);
+        IEnumerator<T>* enumerator = batch.GetEnumerator();
+        while (enumerator->MoveNext()) {
+            sink.Push(enumerator->Current());
+        }
+        delete enumerator;
+        Merge(items.GetData(), items.GetSize());
+    }
+
+    void Append(const T& item) override {
+        int size = array.GetSize();
+        if (size > 0 && compare(item, array.GetData()[size - 1])) {
+            throw InvalidArgumentException("Item breaks sort order");
+        }
+        InsertChecked(item, size);
+    }
+
+    void Prepend(const T& item) override {
+        if (array.GetSize() > 0 && compare(array.GetData()[0], item)) {
+            throw InvalidArgumentException("Item breaks sort order");
+        }
+        InsertChecked(item, 0);
+    }
+
+    void InsertAt(const T& item, int index) override {
+        int size = array.GetSize();
+        if (index < 0 || index > size) {
+            throw IndexOutOfRangeException("Invalid insert index");
+        }
+        const T* items = array.GetData();
+        if ((index > 0 && compare(item, items[index - 1])) || (index < size && compare(items[index], item))) {
+            throw InvalidArgumentException("Item breaks sort order");
+        }
+        InsertChecked(item, index);
+    }
+
+    MemoryUsage MemoryFootprint() const override {
+        MemoryUsage usage;
+        usage.payloadBytes = static_cast<long long>(sizeof(T)) * array.GetSize();
+        usage.slackBytes = static_cast<long long>(sizeof(T)) * (array.GetCapacity() - array.GetSize());
+        usage.overheadBytes = static_cast<long long>(sizeof(T)) * eytzinger.GetCapacity() +
+                              static_cast<long long>(sizeof(int)) * ranks.GetCapacity();
+        return usage;
+    }
+
+    Sequence<T>* GetSubsequence(int startIndex, int endIndex) const override {
+        if (startIndex < 0 || endIndex >= array.GetSize() || startIndex > endIndex) {
+            throw IndexOutOfRangeException("Invalid subsequence indices");
+        }
+        DynamicArray<T> result(array.GetData() + startIndex, endIndex - startIndex + 1);
+        return new SortedArraySequence<T, Compare>(SortedTag(), std::move(result), compare, layout);
+    }
+
+    // Подмножество упорядоченного массива тоже упорядочено
+    Sequence<T>* Where(bool (*predicate)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("Where", "SortedArraySequence");
+        DynamicArray<T> result;
+        DynamicArraySink<T> sink(result);
+        const T* items = array.GetData();
+        for (int i = 0; i < array.GetSize(); ++i) {
+            if (predicate(items[i])) {
+                sink.Push(items[i]);
+            }
+        }
+        SEQUENCE_TRACE_OUTPUT(result.GetSize());
+        return new SortedArraySequence<T, Compare>(SortedTag(), std::move(result), compare, layout);
+    }
+
+    T Reduce(T (*func)(const T&, const T&), const T& initial) const override {
+        SEQUENCE_TRACE_SCOPE("Reduce", "SortedArraySequence");
+        T result = initial;
+        const T* items = array.GetData();
+        for (int i = 0; i < array.GetSize(); ++i) {
+            result = func(result, items[i]);
+        }
+        return result;
+    }
+
+protected:
+    void CopyRangeInto(int begin, int end, DynamicArray<T>& result) const override {
+        result = DynamicArray<T>(array.GetData() + begin, end - begin);
+    }
+};
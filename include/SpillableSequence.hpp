@@ -0,0 +1,559 @@
+#pragma once
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Sequence.hpp"
+#include "DynamicArray.hpp"
+#include "Exceptions.hpp"
+#include "TempFile.hpp"
+
+// Счётчики обмена с диском
+struct SpillStats {
+    long long pageReads = 0;
+    long long pageWrites = 0;
+    long long prefetchHints = 0;
+};
+
+// Последовательность, которая может быть больше оперативной памяти. Элементы лежат
+// страницами по pageSize штук; в памяти держится не больше memoryBudget / размер
+// страницы страниц, остальные вытесняются по LRU во временный файл (TempFile.hpp). Заполненные при Append
+// страницы сразу записываются на диск, так что потоковое добавление не копит грязных
+// страниц. При последовательном перечислении ядру заранее сообщается о следующих
+// страницах (posix_fadvise WILLNEED). Преобразования возвращают SpillableSequence
+// с тем же размером страницы и общим с исходной пулом кадров: бюджет памяти один на
+// всё семейство, а не на каждый результат. Бюджет должен вмещать хотя бы две страницы:
+// преобразование держит страницу источника и пишет страницу результата. Prepend и InsertAt сдвигают хвост — O(n).
+// Не потокобезопасна: даже чтение меняет состояние кэша страниц, причём общего для
+// всех последовательностей семейства.
+template <typename T>
+class SpillableSequence : public Sequence<T> {
+    static_assert(std::is_trivially_copyable<T>::value, "SpillableSequence stores elements as raw bytes");
+
+private:
+    static constexpr int PrefetchDepth = 2;
+
+    struct SharedPoolTag {};
+
+    // Кадр принадлежит последовательности owner, пока в нём лежит её страница;
+    // закреплённый кадр (pins > 0) не вытесняется
+    struct Frame {
+        DynamicArray<T> items;
+        const SpillableSequence<T>* owner = nullptr;
+        int page = -1;
+        int pins = 0;
+        bool dirty = false;
+        unsigned long long lastUse = 0;
+    };
+
+    // Общий пул кадров; удаляется вместе с последней использующей его последовательностью
+    struct FramePool {
+        long long memoryBudget;
+        Frame* frames;
+        int frameCount;
+        unsigned long long useClock = 0;
+        int references = 1;
+    };
+
+    class SpillableEnumerator : public IEnumerator<T> {
+    private:
+        const SpillableSequence<T>& sequence;
+        int currentIndex;
+        T currentValue;
+
+    public:
+        explicit SpillableEnumerator(const SpillableSequence<T>& sequence) : sequence(sequence), currentIndex(-1) {}
+
+        bool MoveNext() override {
+            if (currentIndex + 1 >= sequence.length) {
+                return false;
+            }
+            currentIndex++;
+            if (currentIndex % sequence.pageSize == 0) {
+                sequence.Prefetch(currentIndex / sequence.pageSize + 1);
+            }
+            currentValue = sequence.Get(currentIndex);
+            return true;
+        }
+
+        const T& Current() const override {
+            if (currentIndex < 0 || currentIndex >= sequence.length) {
+                throw InvalidStateException("Enumerator is not in a valid position");
+            }
+            return currentValue;
+        }
+
+        void Reset() override {
+            currentIndex = -1;
+        }
+    };
+
+    class AppendSink : public ISequenceSink<T> {
+    private:
+        SpillableSequence<T>& sequence;
+
+    public:
+        explicit AppendSink(SpillableSequence<T>& sequence) : sequence(sequence) {}
+
+        void Push(const T& item) override {
+            sequence.Append(item);
+        }
+    };
+
+    int pageSize;
+    std::string directory;
+    int fd;
+    int length;
+
+    // Кэш страниц меняется и при чтении
+    FramePool* pool;
+    mutable DynamicArray<int> pageToFrame;
+    mutable SpillStats stats;
+
+    long long GetPageBytes() const {
+        return static_cast<long long>(pageSize) * sizeof(T);
+    }
+
+    int GetPageCount() const {
+        return (length + pageSize - 1) / pageSize;
+    }
+
+    void WritePage(const Frame& frame) const {
+        WriteFileAt(fd, frame.items.GetData(), GetPageBytes(), frame.page * GetPageBytes());
+        ++stats.pageWrites;
+    }
+
+    void ReadPage(Frame& frame) const {
+        ReadFileAt(fd, frame.items.GetData(), GetPageBytes(), frame.page * GetPageBytes());
+        ++stats.pageReads;
+    }
+
+    // Свободный кадр или самый давно использованный из незакреплённых. Вытесняемая
+    // страница может принадлежать другой последовательности пула: грязная уходит в её
+    // файл, а её таблица страниц забывает кадр.
+    Frame& TakeFrame() const {
+        Frame* victim = nullptr;
+        for (int i = 0; i < pool->frameCount; ++i) {
+            Frame& frame = pool->frames[i];
+            if (frame.pins > 0) {
+                continue;
+            }
+            if (frame.page < 0) {
+                victim = &frame;
+                break;
+            }
+            if (victim == nullptr || frame.lastUse < victim->lastUse) {
+                victim = &frame;
+            }
+        }
+        if (victim == nullptr) {
+            throw InvalidStateException("Memory budget holds too few pages for this operation");
+        }
+        if (victim->page >= 0) {
+            if (victim->dirty) {
+                victim->owner->WritePage(*victim);
+            }
+            victim->owner->pageToFrame[victim->page] = -1;
+        }
+        if (victim->items.GetSize() == 0) {
+            victim->items = DynamicArray<T>(pageSize);
+        }
+        victim->owner = this;
+        victim->page = -1;
+        victim->dirty = false;
+        return *victim;
+    }
+
+    Frame& AcquirePage(int page) const {
+        int index = pageToFrame[page];
+        if (index >= 0) {
+            pool->frames[index].lastUse = ++pool->useClock;
+            return pool->frames[index];
+        }
+        Frame& frame = TakeFrame();
+        frame.page = page;
+        ReadPage(frame);
+        frame.lastUse = ++pool->useClock;
+        pageToFrame[page] = static_cast<int>(&frame - pool->frames);
+        return frame;
+    }
+
+    // Новая страница в конце: читать с диска нечего
+    Frame& AddPage() {
+        int page = pageToFrame.GetSize();
+        if (page == pageToFrame.GetCapacity()) {
+            pageToFrame.Reserve(page < 8 ? 8 : page * 2);
+        }
+        pageToFrame.Resize(page + 1);
+        pageToFrame[page] = -1;
+        Frame& frame = TakeFrame();
+        frame.page = page;
+        frame.dirty = true;
+        frame.lastUse = ++pool->useClock;
+        pageToFrame[page] = static_cast<int>(&frame - pool->frames);
+        return frame;
+    }
+
+    T& At(int index) {
+        Frame& frame = AcquirePage(index / pageSize);
+        frame.dirty = true;
+        return frame.items[index % pageSize];
+    }
+
+    // Подсказка ядру прочитать следующие вытесненные страницы заранее
+    void Prefetch(int firstPage) const {
+        int pageCount = GetPageCount();
+        for (int page = firstPage; page < firstPage + PrefetchDepth && page < pageCount; ++page) {
+            if (pageToFrame[page] < 0) {
+                posix_fadvise(fd, static_cast<off_t>(page) * GetPageBytes(), static_cast<off_t>(GetPageBytes()),
+                              POSIX_FADV_WILLNEED);
+                ++stats.prefetchHints;
+            }
+        }
+    }
+
+    // Вызывает visit(items, count) для каждого куска [begin, end), лежащего в одной странице.
+    // Кадр закреплён на время visit: результаты с тем же пулом не вытеснят его из-под чтения.
+    template <typename Visitor>
+    void ForEachSpan(int begin, int end, Visitor visit) const {
+        for (int index = begin; index < end;) {
+            int page = index / pageSize;
+            int offset = index % pageSize;
+            int count = pageSize - offset < end - index ? pageSize - offset : end - index;
+            Prefetch(page + 1);
+            Frame& frame = AcquirePage(page);
+            ++frame.pins;
+            try {
+                visit(frame.items.GetData() + offset, count);
+            } catch (...) {
+                --frame.pins;
+                throw;
+            }
+            --frame.pins;
+            index += count;
+        }
+    }
+
+    // Пустая последовательность на том же пуле кадров
+    SpillableSequence(SharedPoolTag, FramePool* pool, int pageSize, const std::string& directory)
+        : pageSize(pageSize), directory(directory), fd(-1), length(0), pool(pool) {
+        fd = CreateUnlinkedTempFile(directory, "sequence-spill");
+        ++pool->references;
+    }
+
+    SpillableSequence<T>* CreateEmpty() const {
+        return new SpillableSequence<T>(SharedPoolTag(), pool, pageSize, directory);
+    }
+
+    void AppendRange(const SpillableSequence<T>& source, int begin, int end) {
+        source.ForEachSpan(begin, end, [this](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                Append(items[i]);
+            }
+        });
+    }
+
+    void AppendAll(const Sequence<T>* source) {
+        IEnumerator<T>* enumerator = source->GetEnumerator();
+        while (enumerator->MoveNext()) {
+            Append(enumerator->Current());
+        }
+        delete enumerator;
+    }
+
+    void CheckIndex(int index) const {
+        if (index < 0 || index >= length) {
+            throw IndexOutOfRangeException("Index out of range");
+        }
+    }
+
+public:
+    // memoryBudget — байт под страницы в памяти, должно хватать хотя бы на две страницы;
+    // directory — где создать временный файл (по умолчанию $TMPDIR или /tmp)
+    explicit SpillableSequence(long long memoryBudget = 64LL << 20, int pageSize = 1 << 16,
+                               const std::string& directory = "")
+        : pageSize(pageSize), directory(directory), fd(-1), length(0), pool(nullptr) {
+        if (pageSize <= 0) {
+            throw InvalidSizeException("Page size must be positive");
+        }
+        if (memoryBudget < 2 * GetPageBytes()) {
+            throw InvalidArgumentException("Memory budget must hold at least two pages");
+        }
+        long long maxFrames = memoryBudget / GetPageBytes();
+        int frameCount = maxFrames > (1 << 20) ? (1 << 20) : static_cast<int>(maxFrames);
+        // Сначала память, потом файл: при нехватке памяти дескриптор не утечёт
+        Frame* frames = new Frame[frameCount];
+        try {
+            pool = new FramePool{memoryBudget, frames, frameCount};
+            fd = CreateUnlinkedTempFile(directory, "sequence-spill");
+        } catch (...) {
+            delete pool;
+            delete[] frames;
+            throw;
+        }
+    }
+
+    SpillableSequence(const SpillableSequence&) = delete;
+    SpillableSequence& operator=(const SpillableSequence&) = delete;
+
+    // Свои кадры возвращаются в пул без записи на диск: файл удаляется вместе с нами
+    ~SpillableSequence() override {
+        for (int i = 0; i < pool->frameCount; ++i) {
+            Frame& frame = pool->frames[i];
+            if (frame.owner == this) {
+                frame.owner = nullptr;
+                frame.page = -1;
+                frame.dirty = false;
+            }
+        }
+        if (--pool->references == 0) {
+            delete[] pool->frames;
+            delete pool;
+        }
+        close(fd);
+    }
+
+    const SpillStats& GetStats() const {
+        return stats;
+    }
+
+    // Сколько байт последовательность занимает во временном файле
+    long long GetSpilledBytes() const {
+        struct stat info;
+        return fstat(fd, &info) == 0 ? static_cast<long long>(info.st_size) : 0;
+    }
+
+    // Бюджет общий с последовательностями, полученными из этой преобразованиями
+    long long GetMemoryBudget() const {
+        return pool->memoryBudget;
+    }
+
+    T Get(int index) const override {
+        CheckIndex(index);
+        return AcquirePage(index / pageSize).items[index % pageSize];
+    }
+
+    void Set(int index, const T& item) {
+        CheckIndex(index);
+        At(index) = item;
+    }
+
+    T GetFirst() const override {
+        if (length == 0) {
+            throw EmptySequenceException();
+        }
+        return Get(0);
+    }
+
+    T GetLast() const override {
+        if (length == 0) {
+            throw EmptySequenceException();
+        }
+        return Get(length - 1);
+    }
+
+    Option<T> TryGet(int index) const override {
+        if (index < 0 || index >= length) {
+            return Option<T>::None();
+        }
+        return Option<T>::Some(Get(index));
+    }
+
+    Option<T> TryGetFirst() const override {
+        return TryGet(0);
+    }
+
+    Option<T> TryGetLast() const override {
+        return TryGet(length - 1);
+    }
+
+    int GetLength() const override {
+        return length;
+    }
+
+    // Держит в памяти только кадры страниц и таблицу страниц; из общего пула
+    // учитываются кадры, занятые своими страницами
+    MemoryUsage MemoryFootprint() const override {
+        MemoryUsage usage;
+        long long allocated = 0;
+        long long resident = 0;
+        for (int i = 0; i < pool->frameCount; ++i) {
+            const Frame& frame = pool->frames[i];
+            if (frame.owner != this) {
+                continue;
+            }
+            allocated += static_cast<long long>(frame.items.GetSize()) * sizeof(T);
+            if (frame.page >= 0) {
+                long long pageStart = static_cast<long long>(frame.page) * pageSize;
+                long long used = pageStart + pageSize <= length ? pageSize : length - pageStart;
+                resident += used * static_cast<long long>(sizeof(T));
+            }
+        }
+        usage.payloadBytes = resident;
+        usage.slackBytes = allocated - resident;
+        usage.overheadBytes = static_cast<long long>(pageToFrame.GetCapacity()) * sizeof(int) +
+                              static_cast<long long>(pool->frameCount) * sizeof(Frame);
+        return usage;
+    }
+
+    Sequence<T>* GetSubsequence(int startIndex, int endIndex) const override {
+        if (startIndex < 0 || endIndex >= length || startIndex > endIndex) {
+            throw IndexOutOfRangeException("Invalid subsequence indices");
+        }
+        SpillableSequence<T>* result = CreateEmpty();
+        result->AppendRange(*this, startIndex, endIndex + 1);
+        return result;
+    }
+
+    void Append(const T& item) override {
+        Frame& frame = length % pageSize == 0 ? AddPage() : AcquirePage(length / pageSize);
+        frame.items[length % pageSize] = item;
+        frame.dirty = true;
+        ++length;
+        // Заполненная страница сразу уходит на диск, при вытеснении писать будет нечего
+        if (length % pageSize == 0) {
+            WritePage(frame);
+            frame.dirty = false;
+        }
+    }
+
+    void Prepend(const T& item) override {
+        InsertAt(item, 0);
+    }
+
+    void InsertAt(const T& item, int index) override {
+        if (index < 0 || index > length) {
+            throw IndexOutOfRangeException("Invalid insert index");
+        }
+        if (index == length) {
+            Append(item);
+            return;
+        }
+        Append(Get(length - 1));
+        for (int i = length - 2; i > index; --i) {
+            At(i) = Get(i - 1);
+        }
+        At(index) = item;
+    }
+
+    Sequence<T>* Map(T (*func)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("Map", "SpillableSequence");
+        SpillableSequence<T>* result = CreateEmpty();
+        ForEachSpan(0, length, [result, func](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                result->Append(func(items[i]));
+            }
+        });
+        SEQUENCE_TRACE_OUTPUT(result->GetLength());
+        return result;
+    }
+
+    Sequence<T>* Where(bool (*predicate)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("Where", "SpillableSequence");
+        SpillableSequence<T>* result = CreateEmpty();
+        ForEachSpan(0, length, [result, predicate](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                if (predicate(items[i])) {
+                    result->Append(items[i]);
+                }
+            }
+        });
+        SEQUENCE_TRACE_OUTPUT(result->GetLength());
+        return result;
+    }
+
+    T Reduce(T (*func)(const T&, const T&), const T& initialValue) const override {
+        SEQUENCE_TRACE_SCOPE("Reduce", "SpillableSequence");
+        T result = initialValue;
+        ForEachSpan(0, length, [&result, func](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                result = func(result, items[i]);
+            }
+        });
+        return result;
+    }
+
+    Sequence<T>* FlatMap(Sequence<T>* (*func)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("FlatMap", "SpillableSequence");
+        SpillableSequence<T>* result = CreateEmpty();
+        for (int i = 0; i < length; ++i) {
+            Sequence<T>* part = func(Get(i));
+            result->AppendAll(part);
+            delete part;
+        }
+        SEQUENCE_TRACE_OUTPUT(result->GetLength());
+        return result;
+    }
+
+    Sequence<T>* FlatMap(void (*func)(const T&, ISequenceSink<T>&)) const override {
+        SEQUENCE_TRACE_SCOPE("FlatMap", "SpillableSequence");
+        SpillableSequence<T>* result = CreateEmpty();
+        AppendSink sink(*result);
+        for (int i = 0; i < length; ++i) {
+            func(Get(i), sink);
+        }
+        SEQUENCE_TRACE_OUTPUT(result->GetLength());
+        return result;
+    }
+
+    Option<T> Find(bool (*predicate)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("Find", "SpillableSequence");
+        for (int i = 0; i < length; ++i) {
+            T current = Get(i);
+            if (predicate(current)) {
+                return Option<T>::Some(current);
+            }
+        }
+        return Option<T>::None();
+    }
+
+    std::pair<Sequence<T>*, Sequence<T>*> Split(bool (*predicate)(const T&)) const override {
+        SEQUENCE_TRACE_SCOPE("Split", "SpillableSequence");
+        SpillableSequence<T>* matching = CreateEmpty();
+        SpillableSequence<T>* notMatching = CreateEmpty();
+        ForEachSpan(0, length, [matching, notMatching, predicate](const T* items, int count) {
+            for (int i = 0; i < count; ++i) {
+                (predicate(items[i]) ? matching : notMatching)->Append(items[i]);
+            }
+        });
+        SEQUENCE_TRACE_OUTPUT(matching->GetLength() + notMatching->GetLength());
+        return std::make_pair(matching, notMatching);
+    }
+
+    Sequence<T>* Concat(const Sequence<T>* other) const override {
+        SEQUENCE_TRACE_SCOPE("Concat", "SpillableSequence");
+        SpillableSequence<T>* result = CreateEmpty();
+        result->AppendRange(*this, 0, length);
+        result->AppendAll(other);
+        SEQUENCE_TRACE_OUTPUT(result->GetLength());
+        return result;
+    }
+
+    Sequence<T>* Slice(int i, int N, const Sequence<T>* s = nullptr) const override {
+        SEQUENCE_TRACE_SCOPE("Slice", "SpillableSequence");
+        if (i < 0) {
+            i = length + i;
+        }
+        if (i < 0 || i >= length) {
+            throw IndexOutOfRangeException("Invalid slice index");
+        }
+        if (i + N > length) {
+            N = length - i;
+        }
+        SpillableSequence<T>* result = CreateEmpty();
+        result->AppendRange(*this, 0, i);
+        if (s != nullptr) {
+            result->AppendAll(s);
+        }
+        result->AppendRange(*this, i + N, length);
+        SEQUENCE_TRACE_OUTPUT(result->GetLength());
+        return result;
+    }
+
+    IEnumerator<T>* GetEnumerator() const override {
+        SEQUENCE_COUNT(EnumeratorAllocations, 1);
+        return new SpillableEnumerator(*this);
+    }
+};
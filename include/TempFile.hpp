@@ -0,0 +1,59 @@
+#pragma once
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include "Exceptions.hpp"
+
+// Временный файл для выгрузки данных на диск. Удаляется из каталога сразу после
+// создания: место освобождается, когда закрыт дескриптор или завершился процесс.
+// directory по умолчанию — $TMPDIR или /tmp.
+inline int CreateUnlinkedTempFile(const std::string& directory, const char* prefix) {
+    std::string base = directory;
+    if (base.empty()) {
+        const char* tmp = std::getenv("TMPDIR");
+        base = tmp && *tmp ? tmp : "/tmp";
+    }
+    std::string path = base + "/" + prefix + "-XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd < 0) {
+        throw InvalidStateException("Cannot create temporary file in '" + base + "'");
+    }
+    unlink(path.c_str());
+    return fd;
+}
+
+// pwrite до конца, с повтором после EINTR
+inline void WriteFileAt(int fd, const void* data, long long bytes, long long offset) {
+    const char* source = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t written = pwrite(fd, source, static_cast<std::size_t>(bytes), static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            throw InvalidStateException("Failed to write temporary file");
+        }
+        source += written;
+        offset += written;
+        bytes -= written;
+    }
+}
+
+// pread ровно bytes байт; короткий файл — ошибка
+inline void ReadFileAt(int fd, void* data, long long bytes, long long offset) {
+    char* target = static_cast<char*>(data);
+    while (bytes > 0) {
+        ssize_t got = pread(fd, target, static_cast<std::size_t>(bytes), static_cast<off_t>(offset));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            throw InvalidStateException("Failed to read temporary file");
+        }
+        target += got;
+        offset += got;
+        bytes -= got;
+    }
+}
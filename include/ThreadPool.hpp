@@ -0,0 +1,152 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Пул потоков библиотеки. Задачи ParallelFor разбиваются на чанки, которые
+// разбирают и рабочие потоки, и вызывающий поток, поэтому вложенные вызовы
+// не приводят к взаимоблокировке.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping;
+
+    struct ParallelForState {
+        std::atomic<int> nextChunk{0};
+        std::atomic<int> finishedChunks{0};
+        int chunkCount = 0;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+
+    template <typename F>
+    static void RunChunks(const std::shared_ptr<ParallelForState>& state, F& body) {
+        while (true) {
+            int chunk = state->nextChunk.fetch_add(1);
+            if (chunk >= state->chunkCount) {
+                return;
+            }
+            try {
+                body(chunk);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) {
+                    state->error = std::current_exception();
+                }
+            }
+            if (state->finishedChunks.fetch_add(1) + 1 == state->chunkCount) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done.notify_all();
+            }
+        }
+    }
+
+    void WorkerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+public:
+    explicit ThreadPool(int workerCount) : stopping(false) {
+        for (int i = 0; i < workerCount; ++i) {
+            workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    static ThreadPool& Instance() {
+        static ThreadPool pool(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) - 1);
+        return pool;
+    }
+
+    int GetWorkerCount() const {
+        return static_cast<int>(workers.size());
+    }
+
+    // Вызывает body(chunk) для каждого chunk из [0, chunkCount) и ждёт завершения.
+    // Первое выброшенное исключение пробрасывается вызывающему.
+    template <typename F>
+    void ParallelFor(int chunkCount, F body) {
+        if (chunkCount <= 0) {
+            return;
+        }
+        if (chunkCount == 1 || workers.empty()) {
+            for (int chunk = 0; chunk < chunkCount; ++chunk) {
+                body(chunk);
+            }
+            return;
+        }
+
+        auto state = std::make_shared<ParallelForState>();
+        state->chunkCount = chunkCount;
+        auto sharedBody = std::make_shared<F>(std::move(body));
+
+        int helpers = std::min(chunkCount - 1, GetWorkerCount());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (int i = 0; i < helpers; ++i) {
+                tasks.push([state, sharedBody] { RunChunks(state, *sharedBody); });
+            }
+        }
+        condition.notify_all();
+
+        RunChunks(state, *sharedBody);
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait(lock, [&state] { return state->finishedChunks.load() == state->chunkCount; });
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+    }
+};
+
+// Минимальное число элементов на чанк, ниже которого распараллеливание не окупается.
+constexpr int ParallelGrainSize = 16384;
+
+inline int ParallelChunkCount(int length) {
+    int maxChunks = 4 * (ThreadPool::Instance().GetWorkerCount() + 1);
+    int chunks = length / ParallelGrainSize;
+    return std::max(1, std::min(chunks, maxChunks));
+}
+
+// Границы чанка [begin, end) при равномерном делении length элементов на chunkCount частей.
+inline void GetChunkRange(int length, int chunkCount, int chunk, int& begin, int& end) {
+    long long total = length;
+    begin = static_cast<int>(total * chunk / chunkCount);
+    end = static_cast<int>(total * (chunk + 1) / chunkCount);
+}
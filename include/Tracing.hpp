@@ -0,0 +1,159 @@
+#pragma once
+
+// Трассировка операций последовательностей в формате Chrome trace (открывается в
+// Perfetto и chrome://tracing). Включается опцией CMake SEQUENCE_TRACING; без неё
+// макросы раскрываются в пустое выражение.
+//
+//   Sequence<int>* squares = seq.Map(square);   // событие "Map" с длинами входа и выхода
+//   Tracer::FlushToFile("trace.json");
+
+#ifdef SEQUENCE_TRACING
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+struct TraceEvent {
+    const char* name;
+    const char* className;
+    long long startNanoseconds;
+    long long durationNanoseconds;
+    int inputLength;
+    int outputLength;  // -1, если операция не строит последовательность
+};
+
+// Каждый поток пишет в свой кольцевой буфер без блокировок; при переполнении
+// старые события перезаписываются. Flush() стоит вызывать, когда конвейер простаивает:
+// событие, перезаписываемое во время сброса, может выйти испорченным.
+class Tracer {
+private:
+    static const int BufferCapacity = 1 << 16;
+
+    struct ThreadBuffer {
+        TraceEvent events[BufferCapacity];
+        std::atomic<long long> written{0};
+        long long flushed = 0;  // под мьютексом реестра
+        int threadId = 0;
+        ThreadBuffer* next = nullptr;
+    };
+
+    // Буферы живут до конца процесса: потоки пула могут писать в них при завершении
+    struct Registry {
+        std::mutex mutex;
+        ThreadBuffer* head = nullptr;
+        int nextThreadId = 1;
+    };
+
+    static Registry& GetRegistry() {
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    static ThreadBuffer* RegisterThread() {
+        ThreadBuffer* buffer = new ThreadBuffer();
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffer->threadId = registry.nextThreadId++;
+        buffer->next = registry.head;
+        registry.head = buffer;
+        return buffer;
+    }
+
+    static ThreadBuffer& Local() {
+        static thread_local ThreadBuffer* buffer = RegisterThread();
+        return *buffer;
+    }
+
+public:
+    static long long NowNanoseconds() {
+        static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    static void Record(const TraceEvent& event) {
+        ThreadBuffer& buffer = Local();
+        long long index = buffer.written.load(std::memory_order_relaxed);
+        buffer.events[index % BufferCapacity] = event;
+        buffer.written.store(index + 1, std::memory_order_release);
+    }
+
+    // Записывает накопленные события в JSON и забывает их
+    static void Flush(std::ostream& out) {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        out << "{\"traceEvents\":[";
+        bool first = true;
+        for (ThreadBuffer* buffer = registry.head; buffer; buffer = buffer->next) {
+            out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                << buffer->threadId << ",\"args\":{\"name\":\"thread " << buffer->threadId << "\"}}";
+            first = false;
+
+            long long written = buffer->written.load(std::memory_order_acquire);
+            long long begin = std::max(buffer->flushed, written - BufferCapacity);
+            for (long long i = begin; i < written; ++i) {
+                const TraceEvent& event = buffer->events[i % BufferCapacity];
+                out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.className
+                    << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                    << ",\"ts\":" << event.startNanoseconds / 1000 << "." << event.startNanoseconds % 1000 / 100
+                    << ",\"dur\":" << event.durationNanoseconds / 1000 << "." << event.durationNanoseconds % 1000 / 100
+                    << ",\"args\":{\"input\":" << event.inputLength;
+                if (event.outputLength >= 0) {
+                    out << ",\"output\":" << event.outputLength;
+                }
+                out << "}}";
+            }
+            buffer->flushed = written;
+        }
+        out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+    static bool FlushToFile(const std::string& path) {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+        Flush(file);
+        return static_cast<bool>(file);
+    }
+};
+
+// Записывает событие длительностью от создания до разрушения
+class TraceScope {
+private:
+    const char* name;
+    const char* className;
+    int inputLength;
+    int outputLength;
+    long long start;
+
+public:
+    TraceScope(const char* name, const char* className, int inputLength)
+        : name(name), className(className), inputLength(inputLength), outputLength(-1),
+          start(Tracer::NowNanoseconds()) {}
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    ~TraceScope() {
+        Tracer::Record(TraceEvent{name, className, start, Tracer::NowNanoseconds() - start, inputLength, outputLength});
+    }
+
+    void SetOutputLength(int length) {
+        outputLength = length;
+    }
+};
+
+#define SEQUENCE_TRACE_SCOPE(operation, className) \
+    TraceScope sequenceTraceScope(operation, className, this->GetLength())
+#define SEQUENCE_TRACE_OUTPUT(length) sequenceTraceScope.SetOutputLength(length)
+
+#else
+
+#define SEQUENCE_TRACE_SCOPE(operation, className) ((void)0)
+#define SEQUENCE_TRACE_OUTPUT(length) ((void)0)
+
+#endif
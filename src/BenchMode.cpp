@@ -0,0 +1,406 @@
+#include "BenchMode.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Sequence.hpp"
+#include "DynamicArray.hpp"
+#include "ImmutableArraySequence.hpp"
+#include "ImmutableListSequence.hpp"
+#include "MemoryTracker.hpp"
+#include "SequenceSink.hpp"
+#include "Exceptions.hpp"
+#include "Workload.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int square(const int& x) { return static_cast<int>(static_cast<std::uint32_t>(x) * static_cast<std::uint32_t>(x)); }
+bool isEven(const int& x) { return x % 2 == 0; }
+int add(const int& a, const int& b) { return static_cast<int>(static_cast<std::uint32_t>(a) + static_cast<std::uint32_t>(b)); }
+
+enum class BenchOperation { Build, Iterate, Get, Map, Where, Reduce, Concat, Slice, Append, Prepend, Insert };
+
+struct OperationEntry {
+    const char* name;
+    BenchOperation operation;
+};
+
+const OperationEntry benchOperations[] = {
+    {"build", BenchOperation::Build},     {"iterate", BenchOperation::Iterate},
+    {"get", BenchOperation::Get},         {"map", BenchOperation::Map},
+    {"where", BenchOperation::Where},     {"reduce", BenchOperation::Reduce},
+    {"concat", BenchOperation::Concat},   {"slice", BenchOperation::Slice},
+    {"append", BenchOperation::Append},   {"prepend", BenchOperation::Prepend},
+    {"insert", BenchOperation::Insert}};
+
+const SequenceKind allKinds[] = {SequenceKind::Array, SequenceKind::List, SequenceKind::ImmutableArray,
+                                 SequenceKind::ImmutableList};
+
+const char* GetOperationName(BenchOperation operation) {
+    for (const OperationEntry& entry : benchOperations) {
+        if (entry.operation == operation) {
+            return entry.name;
+        }
+    }
+    return "unknown";
+}
+
+BenchOperation ParseOperation(const std::string& name) {
+    for (const OperationEntry& entry : benchOperations) {
+        if (name == entry.name) {
+            return entry.operation;
+        }
+    }
+    std::string known;
+    for (const OperationEntry& entry : benchOperations) {
+        known += (known.empty() ? "" : ", ") + std::string(entry.name);
+    }
+    throw InvalidArgumentException("Unknown operation '" + name + "' (expected: " + known + ")");
+}
+
+bool IsImmutable(SequenceKind kind) {
+    return kind == SequenceKind::ImmutableArray || kind == SequenceKind::ImmutableList;
+}
+
+struct BenchOptions {
+    int size = 100000;
+    std::string distribution = "random";
+    DynamicArray<SequenceKind> kinds;
+    DynamicArray<BenchOperation> operations;
+    int updates = 100;
+    int repeat = 3;
+    std::uint32_t seed = 42;
+};
+
+int ParsePositive(const std::string& option, const std::string& value) {
+    std::size_t parsed = 0;
+    int result = 0;
+    try {
+        result = std::stoi(value, &parsed);
+    } catch (const std::exception&) {
+        parsed = 0;
+    }
+    if (parsed != value.size() || result <= 0) {
+        throw InvalidArgumentException("Expected positive integer for " + option + ", got '" + value + "'");
+    }
+    return result;
+}
+
+// Разбивает "a,b,c" и добавляет разобранные элементы в result
+template <typename T>
+void ParseList(const std::string& value, T (*parse)(const std::string&), DynamicArray<T>& result) {
+    DynamicArraySink<T> sink(result);
+    std::istringstream items(value);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        if (!item.empty()) {
+            sink.Push(parse(item));
+        }
+    }
+    if (result.GetSize() == 0) {
+        throw InvalidArgumentException("Empty list '" + value + "'");
+    }
+}
+
+BenchOptions ParseOptions(int argc, char** argv) {
+    BenchOptions options;
+    for (int i = 0; i < argc; i += 2) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            throw InvalidArgumentException("Missing value for " + option);
+        }
+        std::string value = argv[i + 1];
+        if (option == "--size") {
+            options.size = ParsePositive(option, value);
+        } else if (option == "--distribution") {
+            options.distribution = value;
+        } else if (option == "--kinds") {
+            ParseList(value, ParseSequenceKind, options.kinds);
+        } else if (option == "--ops") {
+            ParseList(value, ParseOperation, options.operations);
+        } else if (option == "--updates") {
+            options.updates = ParsePositive(option, value);
+        } else if (option == "--repeat") {
+            options.repeat = ParsePositive(option, value);
+        } else if (option == "--seed") {
+            options.seed = static_cast<std::uint32_t>(ParsePositive(option, value));
+        } else {
+            throw InvalidArgumentException("Unknown option '" + option + "'");
+        }
+    }
+    if (options.kinds.GetSize() == 0) {
+        options.kinds = DynamicArray<SequenceKind>(allKinds, sizeof(allKinds) / sizeof(allKinds[0]));
+    }
+    if (options.operations.GetSize() == 0) {
+        DynamicArraySink<BenchOperation> sink(options.operations);
+        for (const OperationEntry& entry : benchOperations) {
+            sink.Push(entry.operation);
+        }
+    }
+    return options;
+}
+
+struct Measurement {
+    double seconds;
+    long long peakBytes;
+    long long elements;
+};
+
+// Один замер одной операции над одной реализацией. Подготовка (копии для
+// изменяющих операций) и освобождение результатов в замер не входят.
+class BenchRunner {
+private:
+    SequenceKind kind;
+    const DynamicArray<int>& items;
+    const Sequence<int>& base;
+    const DynamicArray<int>& positions;
+    long long& checksum;
+
+    Clock::time_point start;
+    long long liveBefore;
+    Measurement measurement;
+
+    void Start() {
+        MemoryTracker::ResetPeak();
+        liveBefore = MemoryTracker::GetLiveBytes();
+        start = Clock::now();
+    }
+
+    void Stop(long long elements) {
+        measurement.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        measurement.peakBytes = MemoryTracker::GetPeakBytes() - liveBefore;
+        measurement.elements = elements;
+    }
+
+    // Результат операции: учитывается в контрольной сумме и освобождается вне замера
+    void Consume(Sequence<int>* result) {
+        checksum += result->GetLength();
+        delete result;
+    }
+
+    Sequence<int>* UpdateNew(BenchOperation operation, int value, int index) const {
+        if (kind == SequenceKind::ImmutableArray) {
+            const auto& immutable = static_cast<const ImmutableArraySequence<int>&>(base);
+            return operation == BenchOperation::Append ? immutable.AppendNew(value)
+                   : operation == BenchOperation::Prepend ? immutable.PrependNew(value)
+                   : immutable.InsertAtNew(value, index);
+        }
+        const auto& immutable = static_cast<const ImmutableListSequence<int>&>(base);
+        return operation == BenchOperation::Append ? immutable.AppendNew(value)
+               : operation == BenchOperation::Prepend ? immutable.PrependNew(value)
+               : immutable.InsertAtNew(value, index);
+    }
+
+    void RunUpdates(BenchOperation operation) {
+        int updates = positions.GetSize();
+        int length = base.GetLength();
+        if (IsImmutable(kind)) {
+            Start();
+            for (int k = 0; k < updates; ++k) {
+                Sequence<int>* next = UpdateNew(operation, k, positions[k] % (length + 1));
+                checksum += next->GetLength();
+                delete next;
+            }
+            Stop(updates);
+            return;
+        }
+        Sequence<int>* copy = CreateSequence(kind, items.GetData(), items.GetSize());
+        Start();
+        for (int k = 0; k < updates; ++k) {
+            if (operation == BenchOperation::Append) {
+                copy->Append(k);
+            } else if (operation == BenchOperation::Prepend) {
+                copy->Prepend(k);
+            } else {
+                copy->InsertAt(k, positions[k] % (length + k + 1));
+            }
+        }
+        Stop(updates);
+        Consume(copy);
+    }
+
+public:
+    BenchRunner(SequenceKind kind, const DynamicArray<int>& items, const Sequence<int>& base,
+                const DynamicArray<int>& positions, long long& checksum)
+        : kind(kind), items(items), base(base), positions(positions), checksum(checksum),
+          liveBefore(0), measurement{0.0, 0, 0} {}
+
+    Measurement Run(BenchOperation operation) {
+        int length = base.GetLength();
+        switch (operation) {
+            case BenchOperation::Build: {
+                Start();
+                Sequence<int>* built = CreateSequence(kind, items.GetData(), items.GetSize());
+                Stop(length);
+                Consume(built);
+                break;
+            }
+            case BenchOperation::Iterate: {
+                Start();
+                IEnumerator<int>* enumerator = base.GetEnumerator();
+                long long sum = 0;
+                while (enumerator->MoveNext()) {
+                    sum += enumerator->Current();
+                }
+                delete enumerator;
+                Stop(length);
+                checksum += sum;
+                break;
+            }
+            case BenchOperation::Get: {
+                int lookups = positions.GetSize();
+                Start();
+                long long sum = 0;
+                for (int k = 0; k < lookups; ++k) {
+                    sum += base.Get(positions[k] % length);
+                }
+                Stop(lookups);
+                checksum += sum;
+                break;
+            }
+            case BenchOperation::Map: {
+                Start();
+                Sequence<int>* result = base.Map(square);
+                Stop(length);
+                Consume(result);
+                break;
+            }
+            case BenchOperation::Where: {
+                Start();
+                Sequence<int>* result = base.Where(isEven);
+                Stop(length);
+                Consume(result);
+                break;
+            }
+            case BenchOperation::Reduce: {
+                Start();
+                int result = base.Reduce(add, 0);
+                Stop(length);
+                checksum += result;
+                break;
+            }
+            case BenchOperation::Concat: {
+                Start();
+                Sequence<int>* result = base.Concat(&base);
+                Stop(2LL * length);
+                Consume(result);
+                break;
+            }
+            case BenchOperation::Slice: {
+                // Удаление средней половины
+                Start();
+                Sequence<int>* result = base.Slice(length / 4, length / 2);
+                Stop(length);
+                Consume(result);
+                break;
+            }
+            case BenchOperation::Append:
+            case BenchOperation::Prepend:
+            case BenchOperation::Insert:
+                RunUpdates(operation);
+                break;
+        }
+        return measurement;
+    }
+};
+
+// Дополняет до width символов; ширина считается в кодовых точках UTF-8
+std::string Pad(const std::string& text, int width) {
+    int length = 0;
+    for (unsigned char c : text) {
+        if ((c & 0xC0) != 0x80) {
+            ++length;
+        }
+    }
+    return length < width ? text + std::string(width - length, ' ') : text;
+}
+
+std::string Format(double value, int precision) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(precision) << value;
+    return text.str();
+}
+
+std::string Megabytes(long long bytes) {
+    return Format(bytes / (1024.0 * 1024.0), 2);
+}
+
+void PrintUsage(std::ostream& output) {
+    output << "Использование: Lab2 bench [--size N] [--distribution sequential|random|skewed|zeros]\n"
+              "                  [--kinds array,list,immutable-array,immutable-list]\n"
+              "                  [--ops build,iterate,get,map,where,reduce,concat,slice,append,prepend,insert]\n"
+              "                  [--updates K] [--repeat R] [--seed S]"
+           << std::endl;
+}
+
+}  // namespace
+
+int RunBench(int argc, char** argv, std::ostream& output) {
+    BenchOptions options;
+    DynamicArray<int> items;
+    try {
+        options = ParseOptions(argc, argv);
+        items = GenerateWorkload(options.size, options.distribution, options.seed);
+    } catch (const SequenceException& e) {
+        std::cerr << "Ошибка: " << e.what() << std::endl;
+        PrintUsage(std::cerr);
+        return 1;
+    }
+
+    // Позиции для get/insert общие для всех реализаций
+    DynamicArray<int> positions = GenerateWorkload(options.updates, "random", options.seed + 1);
+    for (int k = 0; k < positions.GetSize(); ++k) {
+        positions[k] = positions[k] & 0x7FFFFFFF;
+    }
+
+    output << "Элементов: " << options.size << ", распределение " << options.distribution << ", обращений "
+           << options.updates << ", повторов " << options.repeat << " (лучшее время)" << std::endl;
+    output << Pad("Реализация", 17) << Pad("Операция", 10) << Pad("Объём", 12) << Pad("Время, мс", 12)
+           << Pad("Млн эл./с", 12) << Pad("нс/эл.", 12) << "Пик памяти, МБ" << std::endl;
+
+    long long checksum = 0;
+    DynamicArray<MemoryUsage> footprints(options.kinds.GetSize());
+    for (int i = 0; i < options.kinds.GetSize(); ++i) {
+        SequenceKind kind = options.kinds[i];
+        Sequence<int>* base = CreateSequence(kind, items.GetData(), items.GetSize());
+        footprints[i] = base->MemoryFootprint();
+        BenchRunner runner(kind, items, *base, positions, checksum);
+
+        for (int j = 0; j < options.operations.GetSize(); ++j) {
+            BenchOperation operation = options.operations[j];
+            Measurement best = runner.Run(operation);
+            for (int r = 1; r < options.repeat; ++r) {
+                Measurement next = runner.Run(operation);
+                if (next.seconds < best.seconds) {
+                    best.seconds = next.seconds;
+                }
+                if (next.peakBytes > best.peakBytes) {
+                    best.peakBytes = next.peakBytes;
+                }
+            }
+            double throughput = best.seconds > 0.0 ? best.elements / best.seconds / 1e6 : 0.0;
+            double nanoseconds = best.elements > 0 ? best.seconds * 1e9 / best.elements : 0.0;
+            output << Pad(GetSequenceKindName(kind), 17) << Pad(GetOperationName(operation), 10)
+                   << Pad(std::to_string(best.elements), 12) << Pad(Format(best.seconds * 1e3, 3), 12)
+                   << Pad(Format(throughput, 3), 12) << Pad(Format(nanoseconds, 1), 12)
+                   << (MemoryTracker::Enabled ? Megabytes(best.peakBytes) : "—") << std::endl;
+        }
+        delete base;
+    }
+
+    output << std::endl << "Занимаемая память (MemoryFootprint):" << std::endl;
+    output << Pad("Реализация", 17) << Pad("Данные, МБ", 12) << Pad("Запас, МБ", 12) << Pad("Служебные, МБ", 15)
+           << "Байт на элемент" << std::endl;
+    for (int i = 0; i < options.kinds.GetSize(); ++i) {
+        const MemoryUsage& usage = footprints[i];
+        output << Pad(GetSequenceKindName(options.kinds[i]), 17) << Pad(Megabytes(usage.payloadBytes), 12)
+               << Pad(Megabytes(usage.slackBytes), 12) << Pad(Megabytes(usage.overheadBytes), 15)
+               << Format(static_cast<double>(usage.GetTotalBytes()) / options.size, 1) << std::endl;
+    }
+    output << "Контрольная сумма: " << checksum << std::endl;
+    return 0;
+}
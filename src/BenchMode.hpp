@@ -0,0 +1,20 @@
+#pragma once
+#include <ostream>
+
+// Встроенный бенчмарк Lab2: строит последовательности заданного размера и
+// распределения, прогоняет выбранные операции над каждой реализацией и печатает
+// таблицу пропускной способности и памяти. Параметры (все необязательные):
+//
+//   --size N           число элементов (100000)
+//   --distribution D   sequential | random | skewed | zeros (random)
+//   --kinds a,b,...    array, list, immutable-array, immutable-list (все)
+//   --ops a,b,...      build, iterate, get, map, where, reduce, concat, slice,
+//                      append, prepend, insert (все)
+//   --updates K        число обращений для get/append/prepend/insert (100)
+//   --repeat R         повторов каждого замера, печатается лучший (3)
+//   --seed S           зерно генератора (42)
+//
+// Для неизменяемых реализаций append/prepend/insert идут через AppendNew/PrependNew/
+// InsertAtNew, каждый вызов копирует последовательность целиком.
+// argv — аргументы после "bench". Возвращает код завершения программы.
+int RunBench(int argc, char** argv, std::ostream& output);
@@ -0,0 +1,437 @@
+#include "ScriptMode.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include "Sequence.hpp"
+#include "DynamicArray.hpp"
+#include "ArraySequence.hpp"
+#include "ListSequence.hpp"
+#include "ImmutableArraySequence.hpp"
+#include "ImmutableListSequence.hpp"
+#include "MemoryTracker.hpp"
+#include "BulkLoader.hpp"
+#include "SequenceFormatter.hpp"
+#include "SequenceSerialization.hpp"
+#include "MappedArraySequence.hpp"
+#include "Workload.hpp"
+#include "Exceptions.hpp"
+
+namespace {
+
+// Арифметика по модулю 2^32: длинные скрипты не должны упираться в переполнение int
+int wrap(std::uint32_t value) { return static_cast<int>(value); }
+
+int square(const int& x) { return wrap(static_cast<std::uint32_t>(x) * static_cast<std::uint32_t>(x)); }
+int negate(const int& x) { return wrap(0u - static_cast<std::uint32_t>(x)); }
+int increment(const int& x) { return wrap(static_cast<std::uint32_t>(x) + 1u); }
+int twice(const int& x) { return wrap(static_cast<std::uint32_t>(x) * 2u); }
+
+bool isPositive(const int& x) { return x > 0; }
+bool isNegative(const int& x) { return x < 0; }
+bool isEven(const int& x) { return x % 2 == 0; }
+bool isOdd(const int& x) { return x % 2 != 0; }
+
+int add(const int& a, const int& b) { return wrap(static_cast<std::uint32_t>(a) + static_cast<std::uint32_t>(b)); }
+int minimum(const int& a, const int& b) { return a < b ? a : b; }
+int maximum(const int& a, const int& b) { return a > b ? a : b; }
+
+void duplicateIntoSink(const int& x, ISequenceSink<int>& sink) {
+    sink.Push(x);
+    sink.Push(x);
+}
+
+struct MapEntry {
+    const char* name;
+    int (*func)(const int&);
+};
+
+struct PredicateEntry {
+    const char* name;
+    bool (*func)(const int&);
+};
+
+struct ReduceEntry {
+    const char* name;
+    int (*func)(const int&, const int&);
+    int initial;
+};
+
+const MapEntry mapFunctions[] = {
+    {"square", square}, {"negate", negate}, {"increment", increment}, {"double", twice}};
+
+const PredicateEntry predicates[] = {
+    {"positive", isPositive}, {"negative", isNegative}, {"even", isEven}, {"odd", isOdd}};
+
+const ReduceEntry reduceFunctions[] = {
+    {"add", add, 0}, {"min", minimum, INT_MAX}, {"max", maximum, INT_MIN}};
+
+template <typename Entry, int Count>
+const Entry& FindEntry(const Entry (&entries)[Count], const std::string& name, const char* what) {
+    for (int i = 0; i < Count; ++i) {
+        if (name == entries[i].name) {
+            return entries[i];
+        }
+    }
+    std::string known;
+    for (int i = 0; i < Count; ++i) {
+        known += (i > 0 ? ", " : "") + std::string(entries[i].name);
+    }
+    throw InvalidArgumentException("Unknown " + std::string(what) + " '" + name + "' (expected: " + known + ")");
+}
+
+std::string ReadWord(std::istringstream& args, const char* what) {
+    std::string word;
+    if (!(args >> word)) {
+        throw InvalidArgumentException(std::string("Missing argument: ") + what);
+    }
+    return word;
+}
+
+int ReadInt(std::istringstream& args, const char* what) {
+    std::string word = ReadWord(args, what);
+    std::size_t parsed = 0;
+    int value = 0;
+    try {
+        value = std::stoi(word, &parsed);
+    } catch (const std::exception&) {
+        parsed = 0;
+    }
+    if (parsed != word.size()) {
+        throw InvalidArgumentException(std::string("Expected integer for ") + what + ", got '" + word + "'");
+    }
+    return value;
+}
+
+// Текущая последовательность скрипта; каждая операция заменяет её результатом
+class ScriptSession {
+private:
+    Sequence<int>* current;
+    SequenceKind kind;
+
+    Sequence<int>& Current() {
+        if (!current) {
+            throw InvalidStateException("No sequence: use 'create' first");
+        }
+        return *current;
+    }
+
+    void Replace(Sequence<int>* next) {
+        if (next != current) {
+            delete current;
+            current = next;
+        }
+    }
+
+    std::string LengthReport() const {
+        return "длина " + std::to_string(current->GetLength());
+    }
+
+    std::string Create(std::istringstream& args) {
+        SequenceKind createdKind = ParseSequenceKind(ReadWord(args, "sequence type"));
+        int count = ReadInt(args, "count");
+        std::string distribution = ReadWord(args, "distribution");
+        int seed = 42;
+        std::string seedWord;
+        if (args >> seedWord) {
+            std::istringstream seedArgs(seedWord);
+            seed = ReadInt(seedArgs, "seed");
+        }
+        Replace(CreateSequence(createdKind, GenerateWorkload(count, distribution, static_cast<std::uint32_t>(seed))));
+        kind = createdKind;
+        return LengthReport();
+    }
+
+    // Загрузка чисел из файла ("-" — stdin) сразу в хранилище последовательности
+    std::string Load(std::istringstream& args) {
+        SequenceKind loadedKind = ParseSequenceKind(ReadWord(args, "sequence type"));
+        std::string path = ReadWord(args, "file");
+        std::ifstream file;
+        if (path != "-") {
+            file.open(path, std::ios::binary);
+            if (!file) {
+                throw InvalidArgumentException("Cannot open file '" + path + "'");
+            }
+        }
+        BulkLoader<int> loader(path == "-" ? std::cin : file);
+        switch (loadedKind) {
+            case SequenceKind::Array:
+                Replace(loader.LoadArraySequence());
+                break;
+            case SequenceKind::List:
+                Replace(loader.LoadListSequence());
+                break;
+            case SequenceKind::ImmutableArray:
+                Replace(loader.LoadImmutableArraySequence());
+                break;
+            case SequenceKind::ImmutableList:
+                Replace(loader.LoadImmutableListSequence());
+                break;
+        }
+        kind = loadedKind;
+
+        const LoadStats& stats = loader.GetStats();
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1) << LengthReport() << ", " << stats.bytesRead << " Б, "
+             << stats.GetMegabytesPerSecond() << " МБ/с, " << stats.GetValuesPerSecond() / 1e6 << " млн чисел/с";
+        return text.str();
+    }
+
+    // Для неизменяемых последовательностей вставка создаёт новую копию
+    std::string Insert(const std::string& command, std::istringstream& args) {
+        int value = ReadInt(args, "value");
+        int index = command == "insert" ? ReadInt(args, "index") : 0;
+        Sequence<int>& seq = Current();
+        if (kind == SequenceKind::ImmutableArray) {
+            auto& immutable = static_cast<ImmutableArraySequence<int>&>(seq);
+            Replace(command == "append" ? immutable.AppendNew(value)
+                    : command == "prepend" ? immutable.PrependNew(value)
+                    : immutable.InsertAtNew(value, index));
+        } else if (kind == SequenceKind::ImmutableList) {
+            auto& immutable = static_cast<ImmutableListSequence<int>&>(seq);
+            Replace(command == "append" ? immutable.AppendNew(value)
+                    : command == "prepend" ? immutable.PrependNew(value)
+                    : immutable.InsertAtNew(value, index));
+        } else if (command == "append") {
+            seq.Append(value);
+        } else if (command == "prepend") {
+            seq.Prepend(value);
+        } else {
+            seq.InsertAt(value, index);
+        }
+        return LengthReport();
+    }
+
+    std::string Print(std::istringstream& args) {
+        Sequence<int>& seq = Current();
+        std::string mode = "all";
+        args >> mode;
+        std::ostringstream text;
+        {
+            SequenceFormatter<int> formatter(text);
+            if (mode == "all") {
+                formatter.Write(seq);
+            } else if (mode == "head") {
+                formatter.WriteHead(seq, ReadInt(args, "count"));
+            } else if (mode == "tail") {
+                formatter.WriteTail(seq, ReadInt(args, "count"));
+            } else if (mode == "sample") {
+                formatter.WriteSampled(seq, ReadInt(args, "count"));
+            } else {
+                throw InvalidArgumentException("Unknown print mode '" + mode + "' (expected: all, head, tail, sample)");
+            }
+        }
+        text << " из " << seq.GetLength();
+        return text.str();
+    }
+
+    // Выгрузка по числу на строку; файл читается обратно командой load
+    std::string Save(std::istringstream& args) {
+        Sequence<int>& seq = Current();
+        std::string path = ReadWord(args, "file");
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            throw InvalidArgumentException("Cannot open file '" + path + "'");
+        }
+        {
+            SequenceFormatter<int> formatter(file, FormatStyle::Lines(), 1 << 20);
+            formatter.Write(seq);
+        }
+        if (!file.flush()) {
+            throw InvalidStateException("Failed to write '" + path + "'");
+        }
+        return std::to_string(static_cast<long long>(file.tellp())) + " Б";
+    }
+
+    // Двоичный формат SequenceSerializer
+    std::string SaveBinary(std::istringstream& args) {
+        Sequence<int>& seq = Current();
+        std::string path = ReadWord(args, "file");
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            throw InvalidArgumentException("Cannot open file '" + path + "'");
+        }
+        SequenceSerializer<int>::Save(seq, file);
+        if (!file.flush()) {
+            throw InvalidStateException("Failed to write '" + path + "'");
+        }
+        return std::to_string(static_cast<long long>(file.tellp())) + " Б";
+    }
+
+    std::string LoadBinary(std::istringstream& args) {
+        SequenceKind loadedKind = ParseSequenceKind(ReadWord(args, "sequence type"));
+        std::string path = ReadWord(args, "file");
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw InvalidArgumentException("Cannot open file '" + path + "'");
+        }
+        switch (loadedKind) {
+            case SequenceKind::Array:
+                Replace(SequenceSerializer<int>::LoadArraySequence(file));
+                break;
+            case SequenceKind::List:
+                Replace(SequenceSerializer<int>::LoadListSequence(file));
+                break;
+            case SequenceKind::ImmutableArray:
+                Replace(SequenceSerializer<int>::LoadImmutableArraySequence(file));
+                break;
+            case SequenceKind::ImmutableList:
+                Replace(SequenceSerializer<int>::LoadImmutableListSequence(file));
+                break;
+        }
+        kind = loadedKind;
+        return LengthReport();
+    }
+
+    // Файл в формате savebin отображается в память без чтения; изменять такую последовательность нельзя
+    std::string MapFile(std::istringstream& args) {
+        Replace(new MappedArraySequence<int>(ReadWord(args, "file")));
+        kind = SequenceKind::Array;
+        return LengthReport();
+    }
+
+    std::string Memory() {
+        MemoryUsage usage = Current().MemoryFootprint();
+        std::ostringstream text;
+        text << "данные " << usage.payloadBytes << " Б, запас " << usage.slackBytes
+             << " Б, служебные " << usage.overheadBytes << " Б; библиотека: ";
+        if (MemoryTracker::Enabled) {
+            text << "сейчас " << MemoryTracker::GetLiveBytes() << " Б, пик " << MemoryTracker::GetPeakBytes() << " Б";
+        } else {
+            text << "учёт выключен (SEQUENCE_INSTRUMENTATION)";
+        }
+        return text.str();
+    }
+
+public:
+    ScriptSession() : current(nullptr), kind(SequenceKind::Array) {}
+
+    ScriptSession(const ScriptSession&) = delete;
+    ScriptSession& operator=(const ScriptSession&) = delete;
+
+    ~ScriptSession() {
+        delete current;
+    }
+
+    // Выполняет команду и возвращает текст результата
+    std::string Execute(const std::string& command, std::istringstream& args) {
+        if (command == "create") {
+            return Create(args);
+        }
+        if (command == "load") {
+            return Load(args);
+        }
+        if (command == "append" || command == "prepend" || command == "insert") {
+            return Insert(command, args);
+        }
+        if (command == "map") {
+            Replace(Current().Map(FindEntry(mapFunctions, ReadWord(args, "function"), "function").func));
+            return LengthReport();
+        }
+        if (command == "where") {
+            Replace(Current().Where(FindEntry(predicates, ReadWord(args, "predicate"), "predicate").func));
+            return LengthReport();
+        }
+        if (command == "flatmap") {
+            std::string name = ReadWord(args, "function");
+            if (name != "duplicate") {
+                throw InvalidArgumentException("Unknown flatmap function '" + name + "' (expected: duplicate)");
+            }
+            Replace(Current().FlatMap(duplicateIntoSink));
+            return LengthReport();
+        }
+        if (command == "slice") {
+            int index = ReadInt(args, "index");
+            int count = ReadInt(args, "count");
+            Replace(Current().Slice(index, count));
+            return LengthReport();
+        }
+        if (command == "concat") {
+            Replace(Current().Concat(current));
+            return LengthReport();
+        }
+        if (command == "split") {
+            auto parts = Current().Split(FindEntry(predicates, ReadWord(args, "predicate"), "predicate").func);
+            int rest = parts.second->GetLength();
+            delete parts.second;
+            Replace(parts.first);
+            return LengthReport() + ", отброшено " + std::to_string(rest);
+        }
+        if (command == "reduce") {
+            const ReduceEntry& entry = FindEntry(reduceFunctions, ReadWord(args, "function"), "function");
+            return std::to_string(Current().Reduce(entry.func, entry.initial));
+        }
+        if (command == "find") {
+            Option<int> found = Current().Find(FindEntry(predicates, ReadWord(args, "predicate"), "predicate").func);
+            return found.isSome() ? std::to_string(found.getValue()) : "не найдено";
+        }
+        if (command == "get") {
+            return std::to_string(Current().Get(ReadInt(args, "index")));
+        }
+        if (command == "length") {
+            return std::to_string(Current().GetLength());
+        }
+        if (command == "print") {
+            return Print(args);
+        }
+        if (command == "save") {
+            return Save(args);
+        }
+        if (command == "savebin") {
+            return SaveBinary(args);
+        }
+        if (command == "loadbin") {
+            return LoadBinary(args);
+        }
+        if (command == "mmap") {
+            return MapFile(args);
+        }
+        if (command == "memory") {
+            return Memory();
+        }
+        throw InvalidArgumentException("Unknown command '" + command + "'");
+    }
+};
+
+}  // namespace
+
+int RunScript(std::istream& input, std::ostream& output) {
+    using Clock = std::chrono::steady_clock;
+    ScriptSession session;
+    std::string line;
+    int lineNumber = 0;
+    int commandCount = 0;
+    double totalMilliseconds = 0.0;
+    output << std::fixed << std::setprecision(3);
+
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        std::istringstream args(line);
+        std::string command;
+        if (!(args >> command) || command[0] == '#') {
+            continue;
+        }
+
+        std::string result;
+        Clock::time_point start = Clock::now();
+        try {
+            result = session.Execute(command, args);
+        } catch (const SequenceException& e) {
+            output << "Ошибка в строке " << lineNumber << " (" << line << "): " << e.what() << std::endl;
+            return 1;
+        }
+        double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        output << line << ": " << result << " (" << milliseconds << " ms)" << std::endl;
+        ++commandCount;
+        totalMilliseconds += milliseconds;
+    }
+
+    output << "Выполнено команд: " << commandCount << ", общее время " << totalMilliseconds << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <istream>
+#include <ostream>
+
+// Пакетный режим Lab2: команды читаются построчно и выполняются подряд,
+// после каждой печатается время выполнения. Пример скрипта:
+//
+//   create array 1000000 random
+//   map square
+//   where positive
+//   reduce add
+//   print head 10
+//   load list numbers.txt
+//
+// Пустые строки и строки, начинающиеся с '#', пропускаются. Выполнение
+// останавливается на первой ошибке. Возвращает код завершения программы.
+int RunScript(std::istream& input, std::ostream& output);
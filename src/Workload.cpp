@@ -0,0 +1,104 @@
+#include "Workload.hpp"
+#include <cmath>
+#include <utility>
+#include "ArraySequence.hpp"
+#include "ListSequence.hpp"
+#include "ImmutableArraySequence.hpp"
+#include "ImmutableListSequence.hpp"
+#include "Exceptions.hpp"
+
+namespace {
+
+struct KindEntry {
+    const char* name;
+    SequenceKind kind;
+};
+
+const KindEntry sequenceKinds[] = {
+    {"array", SequenceKind::Array},
+    {"list", SequenceKind::List},
+    {"immutable-array", SequenceKind::ImmutableArray},
+    {"immutable-list", SequenceKind::ImmutableList}};
+
+std::uint32_t NextRandom(std::uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return state;
+}
+
+}  // namespace
+
+SequenceKind ParseSequenceKind(const std::string& name) {
+    for (const KindEntry& entry : sequenceKinds) {
+        if (name == entry.name) {
+            return entry.kind;
+        }
+    }
+    throw InvalidArgumentException("Unknown sequence type '" + name +
+                                   "' (expected: array, list, immutable-array, immutable-list)");
+}
+
+const char* GetSequenceKindName(SequenceKind kind) {
+    for (const KindEntry& entry : sequenceKinds) {
+        if (entry.kind == kind) {
+            return entry.name;
+        }
+    }
+    return "unknown";
+}
+
+DynamicArray<int> GenerateWorkload(int count, const std::string& distribution, std::uint32_t seed) {
+    if (count < 0) {
+        throw InvalidSizeException("Count cannot be negative");
+    }
+    DynamicArray<int> items(count);
+    int* data = items.GetData();
+    std::uint32_t state = seed;
+    if (distribution == "random") {
+        for (int i = 0; i < count; ++i) {
+            data[i] = static_cast<int>(NextRandom(state) >> 12) - (1 << 19);
+        }
+    } else if (distribution == "sequential") {
+        for (int i = 0; i < count; ++i) {
+            data[i] = i;
+        }
+    } else if (distribution == "skewed") {
+        // count^u - 1 при равномерном u из [0, 1)
+        double logRange = std::log(static_cast<double>(count > 1 ? count : 1));
+        for (int i = 0; i < count; ++i) {
+            double u = (NextRandom(state) >> 8) / 16777216.0;
+            data[i] = static_cast<int>(std::exp(u * logRange)) - 1;
+        }
+    } else if (distribution != "zeros") {
+        throw InvalidArgumentException("Unknown distribution '" + distribution +
+                                       "' (expected: random, sequential, skewed, zeros)");
+    }
+    return items;
+}
+
+Sequence<int>* CreateSequence(SequenceKind kind, DynamicArray<int>&& items) {
+    switch (kind) {
+        case SequenceKind::Array:
+            return new ArraySequence<int>(std::move(items));
+        case SequenceKind::List:
+            return new ListSequence<int>(items.GetData(), items.GetSize());
+        case SequenceKind::ImmutableArray:
+            return new ImmutableArraySequence<int>(std::move(items));
+        case SequenceKind::ImmutableList:
+            return new ImmutableListSequence<int>(items.GetData(), items.GetSize());
+    }
+    throw InvalidArgumentException("Unknown sequence type");
+}
+
+Sequence<int>* CreateSequence(SequenceKind kind, const int* items, int count) {
+    switch (kind) {
+        case SequenceKind::Array:
+            return new ArraySequence<int>(items, count);
+        case SequenceKind::List:
+            return new ListSequence<int>(items, count);
+        case SequenceKind::ImmutableArray:
+            return new ImmutableArraySequence<int>(items, count);
+        case SequenceKind::ImmutableList:
+            return new ImmutableListSequence<int>(items, count);
+    }
+    throw InvalidArgumentException("Unknown sequence type");
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "Sequence.hpp"
+#include "DynamicArray.hpp"
+
+// Общие для пакетного режима и бенчмарка генераторы данных и фабрика последовательностей
+
+enum class SequenceKind { Array, List, ImmutableArray, ImmutableList };
+
+// "array", "list", "immutable-array", "immutable-list"
+SequenceKind ParseSequenceKind(const std::string& name);
+const char* GetSequenceKindName(SequenceKind kind);
+
+// Распределения:
+//   sequential — 0, 1, 2, ...
+//   random     — равномерные значения в [-2^19, 2^19) (LCG, воспроизводимо по seed)
+//   skewed     — логарифмически равномерные в [0, count): малые значения встречаются
+//                намного чаще, как горячие ключи в реальных данных
+//   zeros      — одни нули
+DynamicArray<int> GenerateWorkload(int count, const std::string& distribution, std::uint32_t seed);
+
+// Забирает items; для списков элементы копируются в узлы
+Sequence<int>* CreateSequence(SequenceKind kind, DynamicArray<int>&& items);
+Sequence<int>* CreateSequence(SequenceKind kind, const int* items, int count);
@@ -1,3 +1,4 @@
+#include <fstream>
 #include <iostream>
 #include <string>
 #include "Sequence.hpp"
@@ -6,10 +7,13 @@
 #include "ImmutableArraySequence.hpp"
 #include "ImmutableListSequence.hpp"
 #include "SequencePairOperations.hpp"
+#include "SequenceFormatter.hpp"
+#include "ScriptMode.hpp"
+#include "BenchMode.hpp"
 
-Sequence<int>* doubleSequence(const int& x) {
-    auto* seq = new ImmutableArraySequence<int>();
-    return seq->AppendNew(x)->AppendNew(x);
+void doubleIntoSink(const int& x, ISequenceSink<int>& sink) {
+    sink.Push(x);
+    sink.Push(x);
 }
 
 bool isEven(const int& x) {
@@ -27,12 +31,11 @@ void printSequence(const Sequence<T>* seq) {
         std::cout << "Последовательность пуста." << std::endl;
         return;
     }
-    std::cout << "[ ";
-    for (int i = 0; i < seq->GetLength(); ++i) {
-        std::cout << seq->Get(i);
-        if (i < seq->GetLength() - 1) std::cout << ", ";
-    }
-    std::cout << " ]" << std::endl;
+    SequenceFormatter<T> formatter(std::cout);
+    formatter.Write(*seq);
+    formatter.WriteText("\n");
+    formatter.Flush();
+    std::cout.flush();
 }
 
 // Основное меню
@@ -102,6 +105,30 @@ void showImmutableMenu() {
     std::cout << "Введите выбор: ";
 }
 
+// Элементы читаются сразу в хранилище, которое затем забирает последовательность
+template<typename T>
+DynamicArray<T> readArrayItems(int count) {
+    DynamicArray<T> items(count);
+    T* data = items.GetData();
+    std::cout << "Введите " << count << " элементов: ";
+    for (int i = 0; i < count; ++i) {
+        std::cin >> data[i];
+    }
+    return items;
+}
+
+template<typename T>
+LinkedList<T> readListItems(int count) {
+    LinkedList<T> items;
+    std::cout << "Введите " << count << " элементов: ";
+    for (int i = 0; i < count; ++i) {
+        T value;
+        std::cin >> value;
+        items.Append(value);
+    }
+    return items;
+}
+
 template<typename T>
 Sequence<T>* createMutableSequence(bool isArray) {
     int count;
@@ -125,21 +152,10 @@ Sequence<T>* createMutableSequence(bool isArray) {
         }
     }
     
-    T* items = new T[count];
-    std::cout << "Введите " << count << " элементов: ";
-    for (int i = 0; i < count; ++i) {
-        std::cin >> items[i];
-    }
-    
-    Sequence<T>* seq;
     if (isArray) {
-        seq = new ArraySequence<T>(items, count);
-    } else {
-        seq = new ListSequence<T>(items, count);
+        return new ArraySequence<T>(readArrayItems<T>(count));
     }
-    
-    delete[] items;
-    return seq;
+    return new ListSequence<T>(readListItems<T>(count));
 }
 
 template<typename T>
@@ -165,21 +181,10 @@ Sequence<T>* createImmutableSequence(bool isArray) {
         }
     }
     
-    T* items = new T[count];
-    std::cout << "Введите " << count << " элементов: ";
-    for (int i = 0; i < count; ++i) {
-        std::cin >> items[i];
-    }
-    
-    Sequence<T>* seq;
     if (isArray) {
-        seq = new ImmutableArraySequence<T>(items, count);
-    } else {
-        seq = new ImmutableListSequence<T>(items, count);
+        return new ImmutableArraySequence<T>(readArrayItems<T>(count));
     }
-    
-    delete[] items;
-    return seq;
+    return new ImmutableListSequence<T>(readListItems<T>(count));
 }
 
 void handleMutableSequence(Sequence<int>* seq) {
@@ -285,13 +290,8 @@ void handleMutableSequence(Sequence<int>* seq) {
                 std::cout << "Создайте вторую последовательность для операции Zip." << std::endl;
                 Sequence<int>* other = createMutableSequence<int>(true);
                 Sequence<std::pair<int, int>>* result = Zip(*seq, *other);
-                std::cout << "Результат Zip: [ ";
-                for (int i = 0; i < result->GetLength(); ++i) {
-                    auto pair = result->Get(i);
-                    std::cout << "(" << pair.first << ", " << pair.second << ")";
-                    if (i < result->GetLength() - 1) std::cout << ", ";
-                }
-                std::cout << " ]" << std::endl;
+                std::cout << "Результат Zip: ";
+                printSequence(result);
                 delete other;
                 delete result;
             }
@@ -349,7 +349,7 @@ void handleMutableSequence(Sequence<int>* seq) {
                 delete result;
             }
             else if (choice == 17) { // FlatMap
-                Sequence<int>* result = seq->FlatMap(doubleSequence);
+                Sequence<int>* result = seq->FlatMap(doubleIntoSink);
                 std::cout << "Результат FlatMap (каждый элемент удвоен): ";
                 printSequence(result);
                 delete result;
@@ -379,25 +379,19 @@ void handleMutableSequence(Sequence<int>* seq) {
                     std::cout << "Некорректное количество элементов" << std::endl;
                     continue;
                 }
-                int* items = new int[count];
-                std::cout << "Введите " << count << " элементов: ";
-                for (int i = 0; i < count; ++i) {
-                    std::cin >> items[i];
-                }
+                DynamicArray<int> items = readArrayItems<int>(count);
     
                 auto* immutableArraySeq = dynamic_cast<ImmutableArraySequence<int>*>(seq);
                 delete seq;
 
                 if (immutableArraySeq) {
-                    seq = new ImmutableArraySequence<int>(items, count);
+                    seq = new ImmutableArraySequence<int>(std::move(items));
                 } else {
-                    seq = new ImmutableListSequence<int>(items, count);
+                    seq = new ImmutableListSequence<int>(items.GetData(), count);
                 }
                 
                 std::cout << "Создана новая последовательность: ";
                 printSequence(seq);
-                
-                delete[] items;
             }
             else if (choice == 21) { // Print
                 std::cout << "Current sequence: ";
@@ -567,13 +561,8 @@ void handleImmutableSequence(Sequence<int>* seq) {
                 std::cout << "Создайте вторую последовательность для операции Zip." << std::endl;
                 Sequence<int>* other = createImmutableSequence<int>(true);
                 Sequence<std::pair<int, int>>* result = Zip(*seq, *other);
-                std::cout << "Результат Zip: [ ";
-                for (int i = 0; i < result->GetLength(); ++i) {
-                    auto pair = result->Get(i);
-                    std::cout << "(" << pair.first << ", " << pair.second << ")";
-                    if (i < result->GetLength() - 1) std::cout << ", ";
-                }
-                std::cout << " ]" << std::endl;
+                std::cout << "Результат Zip: ";
+                printSequence(result);
                 delete other;
                 delete result;
             }
@@ -602,7 +591,7 @@ void handleImmutableSequence(Sequence<int>* seq) {
                 delete result;
             }
             else if (choice == 16) { // FlatMap
-                Sequence<int>* result = seq->FlatMap(doubleSequence);
+                Sequence<int>* result = seq->FlatMap(doubleIntoSink);
                 std::cout << "FlatMap result (each element doubled): ";
                 printSequence(result);
                 delete result;
@@ -661,26 +650,20 @@ void handleImmutableSequence(Sequence<int>* seq) {
                     std::cout << "Некорректное количество элементов" << std::endl;
                     continue;
                 }
-                int* items = new int[count];
-                std::cout << "Введите " << count << " элементов: ";
-                for (int i = 0; i < count; ++i) {
-                    std::cin >> items[i];
-                }
+                DynamicArray<int> items = readArrayItems<int>(count);
                 
                 auto* immutableArraySeq = dynamic_cast<ImmutableArraySequence<int>*>(seq);
                 
                 delete seq;
                 
                 if (immutableArraySeq) {
-                    seq = new ImmutableArraySequence<int>(items, count);
+                    seq = new ImmutableArraySequence<int>(std::move(items));
                 } else {
-                    seq = new ImmutableListSequence<int>(items, count);
+                    seq = new ImmutableListSequence<int>(items.GetData(), count);
                 }
                 
                 std::cout << "Создана новая последовательность: ";
                 printSequence(seq);
-                
-                delete[] items;
             }
             else if (choice == 21) { // Print
                 std::cout << "Текущая последовательность: ";
@@ -708,7 +691,25 @@ void handleImmutableSequence(Sequence<int>* seq) {
     }
 }
 
-int main() {
+// Lab2 script [файл] — пакетный режим (без файла или с "-" команды читаются из stdin),
+// Lab2 bench [параметры] — встроенный бенчмарк (см. BenchMode.hpp),
+// без аргументов — интерактивное меню.
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        return RunBench(argc - 2, argv + 2, std::cout);
+    }
+    if (argc > 1 && std::string(argv[1]) == "script") {
+        if (argc > 2 && std::string(argv[2]) != "-") {
+            std::ifstream file(argv[2]);
+            if (!file) {
+                std::cerr << "Не удалось открыть файл: " << argv[2] << std::endl;
+                return 1;
+            }
+            return RunScript(file, std::cout);
+        }
+        return RunScript(std::cin, std::cout);
+    }
+
     while (true) {
         showMenu();
         int choice;
@@ -0,0 +1,313 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include "DynamicArray.hpp"
+#include "LinkedList.hpp"
+#include "ArraySequence.hpp"
+#include "ListSequence.hpp"
+#include "ImmutableArraySequence.hpp"
+#include "ImmutableListSequence.hpp"
+#include "SequencePairOperations.hpp"
+#include "Instrumentation.hpp"
+
+// Тесты асимптотики: операции считают копирования элементов, выделения узлов
+// (скалярный new) и перевыделения массивов (new[]) и сравнивают их с границами
+// вида c·n и log n. Квадратичная регрессия ломает тест так же, как ошибка в результате.
+
+namespace {
+
+thread_local long long scalarAllocations = 0;
+thread_local long long arrayAllocations = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    ++scalarAllocations;
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    ++arrayAllocations;
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace {
+
+// Элемент, считающий свои копирования (перемещения не считаются)
+struct Counted {
+    static thread_local long long copies;
+    int value;
+
+    Counted(int value = 0) : value(value) {}
+    Counted(const Counted& other) : value(other.value) { ++copies; }
+    Counted(Counted&& other) noexcept : value(other.value) {}
+    Counted& operator=(const Counted& other) {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+    Counted& operator=(Counted&& other) noexcept {
+        value = other.value;
+        return *this;
+    }
+};
+
+thread_local long long Counted::copies = 0;
+
+struct Counters {
+    long long copies;
+    long long nodeAllocations;
+    long long arrayAllocations;
+};
+
+// Разница счётчиков между созданием и вызовом Stop()
+class Measurement {
+private:
+    Counters start;
+
+public:
+    Measurement() : start{Counted::copies, scalarAllocations, arrayAllocations} {}
+
+    Counters Stop() const {
+        return Counters{Counted::copies - start.copies,
+                        scalarAllocations - start.nodeAllocations,
+                        arrayAllocations - start.arrayAllocations};
+    }
+};
+
+// Ниже порога распараллеливания, чтобы считались только выделения этого потока
+const int N = 1 << 13;
+
+long long LogBound(int n) {
+    return static_cast<long long>(std::ceil(std::log2(n))) + 2;
+}
+
+Counted increment(const Counted& x) { return Counted(x.value + 1); }
+bool isEvenCounted(const Counted& x) { return x.value % 2 == 0; }
+Counted addCounted(const Counted& a, const Counted& b) { return Counted(a.value + b.value); }
+
+void duplicateIntoSink(const Counted& x, ISequenceSink<Counted>& sink) {
+    sink.Push(x);
+    sink.Push(x);
+}
+
+DynamicArray<Counted> MakeItems(int count) {
+    DynamicArray<Counted> items(count);
+    for (int i = 0; i < count; ++i) {
+        items[i] = Counted(i);
+    }
+    return items;
+}
+
+template <typename S>
+S* MakeSequence(int count) {
+    DynamicArray<Counted> items = MakeItems(count);
+    return new S(items.GetData(), count);
+}
+
+}  // namespace
+
+TEST(ArrayComplexityTest, AppendReallocatesLogarithmically) {
+    ArraySequence<Counted> seq;
+    Measurement measurement;
+    for (int i = 0; i < N; ++i) {
+        seq.Append(Counted(i));
+    }
+    Counters counters = measurement.Stop();
+    EXPECT_LE(counters.copies, N);
+    EXPECT_LE(counters.arrayAllocations, LogBound(N));
+}
+
+TEST(ArrayComplexityTest, TransformationsAreLinear) {
+    ArraySequence<Counted>* seq = MakeSequence<ArraySequence<Counted>>(N);
+
+    Measurement map;
+    Sequence<Counted>* mapped = seq->Map(increment);
+    Counters counters = map.Stop();
+    EXPECT_LE(counters.copies, N);
+    EXPECT_LE(counters.arrayAllocations, 1);
+
+    Measurement where;
+    Sequence<Counted>* filtered = seq->Where(isEvenCounted);
+    counters = where.Stop();
+    EXPECT_LE(counters.copies, N);
+    EXPECT_LE(counters.arrayAllocations, LogBound(N));
+
+    Measurement concat;
+    Sequence<Counted>* joined = seq->Concat(mapped);
+    counters = concat.Stop();
+    EXPECT_LE(counters.copies, 2LL * N);
+    EXPECT_LE(counters.arrayAllocations, 2);
+
+    Measurement slice;
+    Sequence<Counted>* sliced = seq->Slice(N / 4, N / 2, filtered);
+    counters = slice.Stop();
+    EXPECT_LE(counters.copies, 2LL * N);
+    EXPECT_LE(counters.arrayAllocations, 2);
+
+    delete mapped;
+    delete filtered;
+    delete joined;
+    delete sliced;
+    delete seq;
+}
+
+TEST(ArrayComplexityTest, ImmutableTransformationsAreLinear) {
+    ImmutableArraySequence<Counted>* seq = MakeSequence<ImmutableArraySequence<Counted>>(N);
+
+    Measurement map;
+    Sequence<Counted>* mapped = seq->Map(increment);
+    Counters counters = map.Stop();
+    EXPECT_LE(counters.copies, N);
+    EXPECT_LE(counters.arrayAllocations, LogBound(N));
+    EXPECT_LE(counters.nodeAllocations, 1);
+
+    Measurement where;
+    Sequence<Counted>* filtered = seq->Where(isEvenCounted);
+    counters = where.Stop();
+    EXPECT_LE(counters.copies, N);
+    EXPECT_LE(counters.arrayAllocations, LogBound(N));
+
+    Measurement flatMap;
+    Sequence<Counted>* doubled = seq->FlatMap(duplicateIntoSink);
+    counters = flatMap.Stop();
+    EXPECT_LE(counters.copies, 2LL * N);
+    EXPECT_LE(counters.arrayAllocations, LogBound(2 * N));
+
+    Measurement concat;
+    Sequence<Counted>* joined = seq->Concat(mapped);
+    counters = concat.Stop();
+    EXPECT_LE(counters.copies, 2LL * N);
+    EXPECT_LE(counters.arrayAllocations, 2);
+
+    delete mapped;
+    delete filtered;
+    delete doubled;
+    delete joined;
+    delete seq;
+}
+
+TEST(ListComplexityTest, AppendAllocatesOneNodePerElement) {
+    LinkedList<Counted> list;
+    Measurement measurement;
+    for (int i = 0; i < N; ++i) {
+        list.Append(Counted(i));
+    }
+    Counters counters = measurement.Stop();
+    EXPECT_EQ(counters.nodeAllocations, N);
+    EXPECT_LE(counters.copies, N);
+    EXPECT_EQ(counters.arrayAllocations, 0);
+}
+
+// Append не должен обходить список: счётчики шагов обхода (Get и InsertAt)
+// за n вставок в конец остаются нулевыми. Вставка в середину — контроль того,
+// что счётчики действительно подключены.
+TEST(ListComplexityTest, AppendDoesNotWalkTheList) {
+    ListSequence<int> seq;
+    InstrumentationSnapshot before = Instrumentation::Snapshot();
+    for (int i = 0; i < N; ++i) {
+        seq.Append(i);
+        seq.InsertAt(i, seq.GetLength());
+    }
+    InstrumentationSnapshot delta = Instrumentation::Snapshot() - before;
+    EXPECT_EQ(delta.Get(InstrumentationCounter::ListGetSteps), 0);
+    EXPECT_EQ(delta.Get(InstrumentationCounter::ListInsertSteps), 0);
+
+    before = Instrumentation::Snapshot();
+    seq.InsertAt(-1, N);
+    delta = Instrumentation::Snapshot() - before;
+    EXPECT_EQ(delta.Get(InstrumentationCounter::ListInsertSteps), N - 1);
+}
+
+TEST(ListComplexityTest, EnumerationDoesNotCopy) {
+    ListSequence<Counted>* seq = MakeSequence<ListSequence<Counted>>(N);
+    Measurement measurement;
+    IEnumerator<Counted>* enumerator = seq->GetEnumerator();
+    long long sum = 0;
+    while (enumerator->MoveNext()) {
+        sum += enumerator->Current().value;
+    }
+    delete enumerator;
+    Counters counters = measurement.Stop();
+    EXPECT_EQ(sum, static_cast<long long>(N) * (N - 1) / 2);
+    EXPECT_EQ(counters.copies, 0);
+    EXPECT_LE(counters.nodeAllocations, 1);
+    delete seq;
+}
+
+TEST(ListComplexityTest, TransformationsAreLinear) {
+    ListSequence<Counted>* seq = MakeSequence<ListSequence<Counted>>(N);
+    ImmutableListSequence<Counted> immutable(*seq);
+
+    Measurement map;
+    Sequence<Counted>* mapped = immutable.Map(increment);
+    Counters counters = map.Stop();
+    EXPECT_LE(counters.nodeAllocations, N + 1);
+    EXPECT_LE(counters.copies, N);
+
+    Measurement where;
+    Sequence<Counted>* filtered = immutable.Where(isEvenCounted);
+    counters = where.Stop();
+    EXPECT_LE(counters.nodeAllocations, N / 2 + 1);
+    EXPECT_LE(counters.copies, N / 2);
+
+    Measurement concat;
+    Sequence<Counted>* joined = seq->Concat(mapped);
+    counters = concat.Stop();
+    EXPECT_LE(counters.nodeAllocations, 2LL * N + 2);
+    EXPECT_LE(counters.copies, 2LL * N);
+
+    Measurement reduce;
+    Counted total = seq->Reduce(addCounted, Counted(0));
+    counters = reduce.Stop();
+    EXPECT_EQ(total.value, N * (N - 1) / 2);
+    EXPECT_LE(counters.copies, 1);
+
+    Measurement split;
+    auto parts = immutable.Split(isEvenCounted);
+    counters = split.Stop();
+    EXPECT_LE(counters.nodeAllocations, N + 2);
+    EXPECT_LE(counters.copies, N);
+
+    delete mapped;
+    delete filtered;
+    delete joined;
+    delete parts.first;
+    delete parts.second;
+    delete seq;
+}
+
+TEST(PairComplexityTest, ZipAndUnzipAreLinearOnLists) {
+    ListSequence<Counted>* first = MakeSequence<ListSequence<Counted>>(N);
+    ListSequence<Counted>* second = MakeSequence<ListSequence<Counted>>(N);
+
+    Measurement zip;
+    auto* pairs = Zip(*first, *second);
+    Counters counters = zip.Stop();
+    EXPECT_LE(counters.copies, 2LL * N);
+    EXPECT_LE(counters.arrayAllocations, 1);
+
+    Measurement unzip;
+    auto columns = Unzip(*pairs);
+    counters = unzip.Stop();
+    EXPECT_LE(counters.copies, 2LL * N);
+    EXPECT_LE(counters.arrayAllocations, 2);
+
+    delete columns.first;
+    delete columns.second;
+    delete pairs;
+    delete first;
+    delete second;
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "DynamicArray.hpp"
+#include "LinkedList.hpp"
+#include "ArraySequence.hpp"
+#include "ListSequence.hpp"
+#include "ImmutableArraySequence.hpp"
+#include "ImmutableListSequence.hpp"
+#include "SpillableSequence.hpp"
+#include "Instrumentation.hpp"
+#include "MemoryTracker.hpp"
+#include "Tracing.hpp"
+
+// Тесты диагностики. Цель собирается с SEQUENCE_INSTRUMENTATION и SEQUENCE_TRACING
+// независимо от опций CMake, поэтому ctest проверяет счётчики, учёт памяти и
+// трассировку и в сборке по умолчанию.
+
+namespace {
+
+int square(const int& x) { return x * x; }
+bool isPositive(const int& x) { return x > 0; }
+bool isEven(const int& x) { return x % 2 == 0; }
+int add(const int& a, const int& b) { return a + b; }
+
+}  // namespace
+
+TEST(InstrumentationTest, CountsHotPaths) {
+    InstrumentationSnapshot before = Instrumentation::Snapshot();
+
+    DynamicArray<int> array(4);
+    array.Resize(2);
+    array.Resize(10);
+    DynamicArray<int> copy(array);
+
+    LinkedList<int> list;
+    for (int i = 0; i < 5; ++i) {
+        list.Append(i);
+    }
+    list.Get(3);
+    list.Get(4);
+
+    ListSequence<int> seq;
+    delete seq.GetEnumerator();
+
+    InstrumentationSnapshot delta = Instrumentation::Snapshot() - before;
+    EXPECT_EQ(delta.Get(InstrumentationCounter::ArrayResizeCalls), 2);
+    EXPECT_EQ(delta.Get(InstrumentationCounter::ArrayReallocations), 1);
+    EXPECT_EQ(delta.Get(InstrumentationCounter::BytesCopied), static_cast<long long>(sizeof(int)) * (2 + 10));
+    EXPECT_EQ(delta.Get(InstrumentationCounter::ListGetWalks), 2);
+    EXPECT_EQ(delta.Get(InstrumentationCounter::ListGetSteps), 7);
+    EXPECT_EQ(delta.Get(InstrumentationCounter::EnumeratorAllocations), 1);
+}
+
+TEST(InstrumentationTest, AggregatesAcrossThreads) {
+    InstrumentationSnapshot before = Instrumentation::Snapshot();
+    std::thread worker([] {
+        LinkedList<int> list;
+        list.Append(1);
+        list.Append(2);
+        list.Get(1);
+    });
+    worker.join();
+
+    InstrumentationSnapshot delta = Instrumentation::Snapshot() - before;
+    EXPECT_EQ(delta.Get(InstrumentationCounter::ListGetWalks), 1);
+    EXPECT_EQ(delta.Get(InstrumentationCounter::ListGetSteps), 1);
+
+    std::ostringstream report;
+    Instrumentation::Report(report);
+    EXPECT_NE(report.str().find("LinkedList::Get walks"), std::string::npos);
+}
+
+TEST(TracingTest, RecordsOperationSpans) {
+    std::ostringstream discarded;
+    Tracer::Flush(discarded);
+
+    int data[] = {1, -2, 3};
+    ArraySequence<int> array(data, 3);
+    Sequence<int>* positive = array.Where(isPositive);
+    ImmutableListSequence<int> list(data, 3);
+    Sequence<int>* squares = list.Map(square);
+    delete positive;
+    delete squares;
+    // Унаследованные операции подписываются именем наследника
+    ImmutableArraySequence<int> frozen(data, 3);
+    frozen.Reduce(add, 0);
+    list.Find(isEven);
+
+    std::ostringstream trace;
+    Tracer::Flush(trace);
+    std::string json = trace.str();
+    EXPECT_NE(json.find("\"name\":\"Where\",\"cat\":\"ArraySequence\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"input\":3,\"output\":2}"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Map\",\"cat\":\"ImmutableListSequence\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Reduce\",\"cat\":\"ImmutableArraySequence\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Find\",\"cat\":\"ImmutableListSequence\""), std::string::npos);
+
+    std::ostringstream empty;
+    Tracer::Flush(empty);
+    EXPECT_EQ(empty.str().find("\"ph\":\"X\""), std::string::npos);
+}
+
+TEST(MemoryTrackerTest, MatchesFootprint) {
+    long long liveBefore = MemoryTracker::GetLiveBytes();
+    {
+        ArraySequence<int> array;
+        for (int i = 0; i < 5; ++i) {
+            array.Append(i);
+        }
+        int data[] = {1, 2, 3};
+        ListSequence<int> list(data, 3);
+        EXPECT_EQ(MemoryTracker::GetLiveBytes() - liveBefore,
+                  array.MemoryFootprint().GetTotalBytes() + list.MemoryFootprint().GetTotalBytes());
+
+        MemoryTracker::ResetPeak();
+        {
+            DynamicArray<int> temporary(100);
+        }
+        EXPECT_GE(MemoryTracker::GetPeakBytes(),
+                  MemoryTracker::GetLiveBytes() + static_cast<long long>(100 * sizeof(int)));
+    }
+    EXPECT_EQ(MemoryTracker::GetLiveBytes(), liveBefore);
+}
+
+TEST(MemoryTrackerTest, SpillableSequenceStaysWithinBudget) {
+    const int pageSize = 1024;
+    const long long budget = 4 * pageSize * sizeof(int);
+    long long liveBefore = MemoryTracker::GetLiveBytes();
+    MemoryTracker::ResetPeak();
+    {
+        SpillableSequence<int> seq(budget, pageSize, testing::TempDir());
+        for (int i = -20000; i < 20000; ++i) {
+            seq.Append(i);
+        }
+        EXPECT_LT(MemoryTracker::GetPeakBytes() - liveBefore, budget + 4096);
+
+        // Результаты Map и Split делят бюджет источника
+        Sequence<int>* squares = seq.Map(square);
+        auto parts = seq.Split(isPositive);
+        EXPECT_EQ(squares->GetLast(), 19999 * 19999);
+        EXPECT_EQ(parts.first->GetLength() + parts.second->GetLength(), 40000);
+        delete parts.first;
+        delete parts.second;
+        delete squares;
+    }
+    // Сверх бюджета только таблицы страниц четырёх последовательностей
+    EXPECT_LT(MemoryTracker::GetPeakBytes() - liveBefore, budget + 4096);
+    EXPECT_EQ(MemoryTracker::GetLiveBytes(), liveBefore);
+}
@@ -1,4 +1,16 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include "Exceptions.hpp"
 #include "Option.hpp"
@@ -10,6 +22,20 @@
 #include "ImmutableArraySequence.hpp"
 #include "ImmutableListSequence.hpp"
 #include "SequencePairOperations.hpp"
+#include "PairColumnSequence.hpp"
+#include "ColumnStore.hpp"
+#include "BulkLoader.hpp"
+#include "SequenceFormatter.hpp"
+#include "SequenceSerialization.hpp"
+#include "MappedArraySequence.hpp"
+#include "SpillableSequence.hpp"
+#include "ExternalSort.hpp"
+#include "CompressedIntSequence.hpp"
+#include "BitSequence.hpp"
+#include "SortedArraySequence.hpp"
+#include "ParallelSort.hpp"
+#include "Selection.hpp"
+#include "HashIndex.hpp"
 
 template <typename T>
 class MockSequence : public Sequence<T> {
@@ -88,6 +114,10 @@ public:
         return nullptr; // Заглушка для тестов
     }
 
+    Sequence<T>* FlatMap(void (*func)(const T&, ISequenceSink<T>&)) const override {
+        return nullptr; // Заглушка для тестов
+    }
+
     Option<T> Find(bool (*predicate)(const T&)) const override {
         return Option<T>::None(); // Заглушка для тестов
     }
@@ -534,6 +564,1255 @@ TEST(SequencePairOperationsTest, UnzipEmptySequence) {
     delete strings;
 }
 
+TEST(SequencePairOperationsTest, ZipMixedAndUnzipList) {
+    int data1[] = {1, 2, 3, 4};
+    int data2[] = {5, 6, 7};
+    ListSequence<int> list(data1, 4);
+    ArraySequence<int> array(data2, 3);
+
+    auto* zipped = Zip(list, array);
+    ASSERT_EQ(zipped->GetLength(), 3);
+    EXPECT_EQ(zipped->Get(2).first, 3);
+    EXPECT_EQ(zipped->Get(2).second, 7);
+
+    ListSequence<std::pair<int, int>> pairList;
+    for (int i = 0; i < zipped->GetLength(); ++i) {
+        pairList.Append(zipped->Get(i));
+    }
+    auto [firsts, seconds] = Unzip(pairList);
+    ASSERT_EQ(firsts->GetLength(), 3);
+    EXPECT_EQ(firsts->Get(0), 1);
+    EXPECT_EQ(seconds->Get(2), 7);
+
+    delete zipped;
+    delete firsts;
+    delete seconds;
+}
+
+TEST(SequencePairOperationsTest, ZipView) {
+    int data1[] = {1, 2, 3};
+    int data2[] = {4, 5};
+    ListSequence<int> list(data1, 3);
+    ArraySequence<int> array(data2, 2);
+
+    ZipView<int, int> view(list, array);
+    EXPECT_EQ(view.GetLength(), 2);
+    EXPECT_EQ(view.Get(1).first, 2);
+    EXPECT_EQ(view.Get(1).second, 5);
+    EXPECT_THROW(view.Get(2), IndexOutOfRangeException);
+
+    IEnumerator<std::pair<int, int>>* enumerator = view.GetEnumerator();
+    EXPECT_THROW(enumerator->Current(), InvalidStateException);
+    EXPECT_TRUE(enumerator->MoveNext());
+    EXPECT_EQ(enumerator->Current().first, 1);
+    EXPECT_TRUE(enumerator->MoveNext());
+    EXPECT_EQ(enumerator->Current().second, 5);
+    EXPECT_FALSE(enumerator->MoveNext());
+    EXPECT_THROW(enumerator->Current(), InvalidStateException);
+    EXPECT_FALSE(enumerator->MoveNext());
+    enumerator->Reset();
+    EXPECT_TRUE(enumerator->MoveNext());
+    EXPECT_EQ(enumerator->Current().first, 1);
+    delete enumerator;
+}
+
+std::pair<int, int> swapPair(const std::pair<int, int>& p) { return std::make_pair(p.second, p.first); }
+bool firstIsEven(const std::pair<int, int>& p) { return p.first % 2 == 0; }
+
+TEST(PairColumnSequenceTest, ZipColumnsAndUnzip) {
+    int data1[] = {1, 2, 3, 4};
+    int data2[] = {10, 20, 30};
+    ArraySequence<int> seq1(data1, 4);
+    ArraySequence<int> seq2(data2, 3);
+
+    PairColumnSequence<int, int>* pairs = ZipColumns(seq1, seq2);
+    ASSERT_EQ(pairs->GetLength(), 3);
+    EXPECT_EQ(pairs->Get(1), std::make_pair(2, 20));
+    EXPECT_EQ(pairs->GetFirstColumn().Get(2), 3);
+    EXPECT_EQ(pairs->GetSecondColumn().Get(0), 10);
+
+    auto [copiedFirst, copiedSecond] = Unzip(*static_cast<Sequence<std::pair<int, int>>*>(pairs));
+    EXPECT_EQ(copiedFirst->Get(2), 3);
+    EXPECT_EQ(copiedSecond->Get(2), 30);
+    EXPECT_EQ(pairs->GetLength(), 3);
+    delete copiedFirst;
+    delete copiedSecond;
+
+    auto [firsts, seconds] = Unzip(std::move(*pairs));
+    ASSERT_EQ(firsts->GetLength(), 3);
+    EXPECT_EQ(firsts->Get(0), 1);
+    EXPECT_EQ(seconds->Get(1), 20);
+    EXPECT_EQ(pairs->GetLength(), 0);
+    delete firsts;
+    delete seconds;
+    delete pairs;
+}
+
+TEST(PairColumnSequenceTest, SequenceOperations) {
+    PairColumnSequence<int, int> seq;
+    seq.Append(std::make_pair(1, 10));
+    seq.Append(std::make_pair(2, 20));
+    seq.Prepend(std::make_pair(0, 0));
+    seq.InsertAt(std::make_pair(5, 50), 2);
+    ASSERT_EQ(seq.GetLength(), 4);
+    EXPECT_EQ(seq.Get(0).first, 0);
+    EXPECT_EQ(seq.Get(2).second, 50);
+    EXPECT_EQ(seq.GetLast().first, 2);
+    EXPECT_THROW(seq.Get(4), IndexOutOfRangeException);
+
+    Sequence<std::pair<int, int>>* swapped = seq.Map(swapPair);
+    EXPECT_EQ(swapped->Get(1), std::make_pair(10, 1));
+    delete swapped;
+
+    auto [even, odd] = seq.Split(firstIsEven);
+    EXPECT_EQ(even->GetLength(), 2);
+    EXPECT_EQ(odd->GetLength(), 2);
+    delete even;
+    delete odd;
+
+    Sequence<std::pair<int, int>>* sliced = seq.Slice(1, 2);
+    ASSERT_EQ(sliced->GetLength(), 2);
+    EXPECT_EQ(sliced->Get(1).first, 2);
+    delete sliced;
+
+    IEnumerator<std::pair<int, int>>* enumerator = seq.GetEnumerator();
+    int count = 0;
+    while (enumerator->MoveNext()) {
+        EXPECT_EQ(enumerator->Current(), seq.Get(count));
+        ++count;
+    }
+    EXPECT_EQ(count, 4);
+    delete enumerator;
+}
+
+bool isPositiveDouble(const double& x) { return x > 0.0; }
+double addDouble(const double& a, const double& b) { return a + b; }
+long long addLong(const long long& a, const long long& b) { return a + b; }
+
+TEST(ColumnStoreTest, ColumnOperations) {
+    std::string names[] = {"id", "price", "quantity"};
+    ColumnStore<int, double, long long> store(names, 3);
+    store.AppendRow(1, 100.5, -2LL);
+    store.AppendRow(2, 250.0, 5LL);
+    store.AppendRow(3, -10.0, 7LL);
+    store.AppendRow(std::make_tuple(4, 300.0, 0LL));
+    EXPECT_EQ(store.GetRowCount(), 4);
+    EXPECT_EQ(store.GetColumnIndex("price"), 1);
+    EXPECT_THROW(store.GetColumnIndex("missing"), InvalidArgumentException);
+    EXPECT_EQ(store.Get<2>(2), 7LL);
+    EXPECT_THROW((ColumnStore<int, double>(names, 3)), InvalidSizeException);
+
+    // Каждый столбец хранится в своём типе, без расширения до общего
+    EXPECT_EQ(store.GetColumn<0>().GetSize(), 4);
+    static_assert(std::is_same<decltype(store.Get<0>(0)), int>::value, "id stays int");
+    static_assert(std::is_same<decltype(store.Get<1>(0)), double>::value, "price stays double");
+
+    Sequence<int>* squared = store.MapColumn<0>(square);
+    EXPECT_EQ(squared->Get(3), 16);
+    delete squared;
+
+    EXPECT_DOUBLE_EQ(store.ReduceColumn<1>(addDouble, 0.0), 640.5);
+    EXPECT_EQ(store.ReduceColumn<2>(addLong, 0LL), 10LL);
+
+    // Фильтр, охватывающий два столбца разных типов
+    SelectionVector positivePrice = store.WhereColumn<1>(isPositiveDouble);
+    SelectionVector both = store.WhereColumn<0>(isEven, &positivePrice);
+    ASSERT_EQ(both.GetCount(), 2);
+    EXPECT_EQ(both.Get(0), 1);
+    EXPECT_EQ(store.ReduceColumn<2>(addLong, 0LL, &positivePrice), 3LL);
+
+    ColumnRowView<int, double, long long> view = store.GetRows(&both);
+    ASSERT_EQ(view.GetLength(), 2);
+    EXPECT_EQ(std::get<0>(view.Get(0)), 2);
+    EXPECT_EQ(std::get<2>(view.Get(0)), 5LL);
+    EXPECT_THROW(view.Append(std::make_tuple(0, 0.0, 0LL)), InvalidOperationException);
+
+    ColumnRowView<int, double, long long> all = store.GetRows();
+    EXPECT_EQ(all.GetLength(), 4);
+    EXPECT_DOUBLE_EQ(std::get<1>(all.GetLast()), 300.0);
+
+    // Выборка с несуществующими строками отклоняется до прохода по столбцу
+    int outside[] = {0, 4};
+    SelectionVector tooFar(DynamicArray<int>(outside, 2));
+    EXPECT_THROW(store.ReduceColumn<0>(add, 0, &tooFar), IndexOutOfRangeException);
+    EXPECT_THROW(store.WhereColumn<0>(isPositive, &tooFar), IndexOutOfRangeException);
+    int negative[] = {-1};
+    SelectionVector beforeFirst(DynamicArray<int>(negative, 1));
+    EXPECT_THROW(store.ReduceColumn<0>(add, 0, &beforeFirst), IndexOutOfRangeException);
+    SelectionVector empty;
+    EXPECT_EQ(store.ReduceColumn<0>(add, 7, &empty), 7);
+    EXPECT_THROW(store.GetRow(4), IndexOutOfRangeException);
+}
+
+TEST(BulkLoaderTest, ParsesIntoSequences) {
+    std::istringstream input("1 -2\n  30\t+4\r\n-2147483648 2147483647");
+    BulkLoader<int> loader(input);
+    ArraySequence<int>* array = loader.LoadArraySequence();
+    ASSERT_EQ(array->GetLength(), 6);
+    EXPECT_EQ(array->Get(1), -2);
+    EXPECT_EQ(array->Get(3), 4);
+    EXPECT_EQ(array->Get(4), INT_MIN);
+    EXPECT_EQ(array->GetLast(), INT_MAX);
+    EXPECT_EQ(loader.GetStats().valuesParsed, 6);
+    EXPECT_EQ(loader.GetStats().bytesRead, 36);
+    delete array;
+
+    // Крошечный буфер: числа разрезаны границами блоков
+    std::istringstream split("123 4567 -89\n");
+    BulkLoader<int> smallBuffer(split, 3);
+    ImmutableListSequence<int>* list = smallBuffer.LoadImmutableListSequence();
+    ASSERT_EQ(list->GetLength(), 3);
+    EXPECT_EQ(list->Get(0), 123);
+    EXPECT_EQ(list->Get(1), 4567);
+    EXPECT_EQ(list->Get(2), -89);
+    delete list;
+}
+
+TEST(BulkLoaderTest, RejectsMalformedInput) {
+    const char* inputs[] = {"1 x 2", "2147483648", "-2147483649", "5 -", "3-4", "1 - 2"};
+    for (const char* text : inputs) {
+        std::istringstream input(text);
+        BulkLoader<int> loader(input);
+        EXPECT_THROW(delete loader.LoadListSequence(), InvalidArgumentException) << text;
+    }
+
+    std::istringstream negative("-1");
+    BulkLoader<unsigned> unsignedLoader(negative);
+    EXPECT_THROW(delete unsignedLoader.LoadArraySequence(), InvalidArgumentException);
+}
+
+TEST(SequenceFormatterTest, WritesRangesAndSamples) {
+    int data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    ListSequence<int> seq(data, 10);
+    std::ostringstream out;
+    {
+        SequenceFormatter<int> formatter(out);
+        formatter.Write(seq);
+        formatter.WriteText("|");
+        formatter.WriteHead(seq, 3);
+        formatter.WriteText("|");
+        formatter.WriteTail(seq, 2);
+        formatter.WriteText("|");
+        formatter.WriteSampled(seq, 3);
+        formatter.WriteText("|");
+        formatter.WriteHead(seq, 0);
+    }
+    EXPECT_EQ(out.str(), "[ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 ]|[ 1, 2, 3, ... ]|[ ..., 9, 10 ]|"
+                         "[ 1, ..., 5, ..., 10 ]|[ ... ]");
+
+    ArraySequence<int> empty;
+    std::ostringstream emptyOut;
+    SequenceFormatter<int>(emptyOut).Write(empty);
+    EXPECT_EQ(emptyOut.str(), "[  ]");
+
+    SequenceFormatter<int> invalid(out);
+    EXPECT_THROW(invalid.WriteHead(seq, -1), InvalidArgumentException);
+}
+
+TEST(SequenceFormatterTest, SmallBufferAndRoundTrip) {
+    ArraySequence<int> seq;
+    for (int i = 0; i < 1000; ++i) {
+        seq.Append(i % 2 == 0 ? -i * 1000 : i);
+    }
+    // Буфер меньше одной строки: всё равно должен выгрузиться целиком
+    std::stringstream lines;
+    {
+        SequenceFormatter<int> formatter(lines, FormatStyle::Lines(), 8);
+        formatter.Write(seq);
+    }
+    BulkLoader<int> loader(lines);
+    ArraySequence<int>* loaded = loader.LoadArraySequence();
+    ASSERT_EQ(loaded->GetLength(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(loaded->Get(i), seq.Get(i));
+    }
+    delete loaded;
+
+    std::pair<int, double> pairs[] = {{1, 0.5}, {2, -1.25}};
+    ArraySequence<std::pair<int, double>> pairSeq(pairs, 2);
+    std::ostringstream pairOut;
+    {
+        SequenceFormatter<std::pair<int, double>> formatter(pairOut);
+        formatter.Write(pairSeq);
+    }
+    EXPECT_EQ(pairOut.str(), "[ (1, 0.5), (2, -1.25) ]");
+}
+
+TEST(SequenceSerializationTest, RoundTripsEveryImplementation) {
+    ArraySequence<int> array;
+    for (int i = 0; i < 10000; ++i) {
+        array.Append(i * 7 - 5000);
+    }
+    std::stringstream fromArray;
+    SequenceSerializer<int>::Save(array, fromArray);
+    EXPECT_EQ(fromArray.str().size(), sizeof(SequenceFileHeader) + 10000 * sizeof(int));
+
+    // Список пишется через перечислитель, но байты совпадают с массивом
+    ListSequence<int> list(array.GetData(), array.GetLength());
+    std::stringstream fromList;
+    SequenceSerializer<int>::Save(list, fromList);
+    EXPECT_EQ(fromList.str(), fromArray.str());
+
+    ListSequence<int>* loadedList = SequenceSerializer<int>::LoadListSequence(fromArray);
+    ImmutableArraySequence<int>* loadedArray = SequenceSerializer<int>::LoadImmutableArraySequence(fromList);
+    ASSERT_EQ(loadedList->GetLength(), 10000);
+    ASSERT_EQ(loadedArray->GetLength(), 10000);
+    for (int i = 0; i < 10000; i += 997) {
+        EXPECT_EQ(loadedList->Get(i), array.Get(i));
+        EXPECT_EQ(loadedArray->Get(i), array.Get(i));
+    }
+    delete loadedList;
+    delete loadedArray;
+
+    ArraySequence<int> empty;
+    std::stringstream emptyData;
+    SequenceSerializer<int>::Save(empty, emptyData);
+    ArraySequence<int>* loadedEmpty = SequenceSerializer<int>::LoadArraySequence(emptyData);
+    EXPECT_EQ(loadedEmpty->GetLength(), 0);
+    delete loadedEmpty;
+
+    std::string words[] = {"", "alpha", std::string(100000, 'x'), "omega"};
+    ImmutableListSequence<std::string> strings(words, 4);
+    std::stringstream stringData;
+    SequenceSerializer<std::string>::Save(strings, stringData);
+    ArraySequence<std::string>* loadedStrings = SequenceSerializer<std::string>::LoadArraySequence(stringData);
+    ASSERT_EQ(loadedStrings->GetLength(), 4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(loadedStrings->Get(i), words[i]);
+    }
+    delete loadedStrings;
+}
+
+// Поток без позиционирования, как у канала
+class UnseekableBuffer : public std::streambuf {
+public:
+    explicit UnseekableBuffer(std::string& data) {
+        setg(&data[0], &data[0], &data[0] + data.size());
+    }
+};
+
+TEST(SequenceSerializationTest, ChecksumIgnoresChunking) {
+    unsigned char bytes[37];
+    for (int i = 0; i < 37; ++i) {
+        bytes[i] = static_cast<unsigned char>(i * 29 + 3);
+    }
+    SequenceChecksum whole;
+    whole.Update(bytes, sizeof(bytes));
+
+    // Куски, которые начинаются и заканчиваются внутри 8-байтовых слов
+    const int pieces[] = {3, 1, 9, 0, 7, 17};
+    SequenceChecksum chunked;
+    int offset = 0;
+    for (int piece : pieces) {
+        chunked.Update(bytes + offset, piece);
+        offset += piece;
+    }
+    ASSERT_EQ(offset, 37);
+    EXPECT_EQ(chunked.Finish(), whole.Finish());
+}
+
+TEST(SequenceSerializationTest, RejectsDamagedData) {
+    double values[] = {1.5, -2.5, 3.25};
+    ArraySequence<double> seq(values, 3);
+    std::stringstream data;
+    SequenceSerializer<double>::Save(seq, data);
+    std::string bytes = data.str();
+
+    std::string corrupted = bytes;
+    corrupted[sizeof(SequenceFileHeader) + 3] ^= 0x10;
+    std::istringstream corruptedInput(corrupted);
+    EXPECT_THROW(delete SequenceSerializer<double>::LoadArraySequence(corruptedInput), SerializationException);
+
+    std::istringstream truncated(bytes.substr(0, bytes.size() - 1));
+    EXPECT_THROW(delete SequenceSerializer<double>::LoadListSequence(truncated), SerializationException);
+
+    std::istringstream wrongType(bytes);
+    EXPECT_THROW(delete SequenceSerializer<long long>::LoadArraySequence(wrongType), SerializationException);
+
+    std::istringstream notSequence("plain text, definitely longer than a header");
+    EXPECT_THROW(delete SequenceSerializer<double>::LoadArraySequence(notSequence), SerializationException);
+
+    // Поддельная длина без данных: ошибка формата, а не попытка выделить гигабайты
+    std::string forged = bytes.substr(0, sizeof(SequenceFileHeader));
+    std::int64_t hugeLength = INT_MAX;
+    std::memcpy(&forged[offsetof(SequenceFileHeader, length)], &hugeLength, sizeof(hugeLength));
+    std::istringstream forgedInput(forged);
+    EXPECT_THROW(delete SequenceSerializer<double>::LoadArraySequence(forgedInput), SerializationException);
+    UnseekableBuffer forgedBuffer(forged);
+    std::istream forgedStream(&forgedBuffer);
+    EXPECT_THROW(delete SequenceSerializer<double>::LoadArraySequence(forgedStream), SerializationException);
+
+    ArraySequence<std::string> words;
+    words.Append("word");
+    std::stringstream wordData;
+    SequenceSerializer<std::string>::Save(words, wordData);
+    std::string forgedWord = wordData.str();
+    std::uint32_t hugeSize = 0xFFFFFFF0u;
+    std::memcpy(&forgedWord[sizeof(SequenceFileHeader)], &hugeSize, sizeof(hugeSize));
+    std::istringstream forgedWordInput(forgedWord);
+    EXPECT_THROW(delete SequenceSerializer<std::string>::LoadArraySequence(forgedWordInput), SerializationException);
+    UnseekableBuffer forgedWordBuffer(forgedWord);
+    std::istream forgedWordStream(&forgedWordBuffer);
+    EXPECT_THROW(delete SequenceSerializer<std::string>::LoadArraySequence(forgedWordStream), SerializationException);
+
+    // Без позиционирования массив растёт по мере чтения
+    UnseekableBuffer streamed(bytes);
+    std::istream streamedInput(&streamed);
+    ArraySequence<double>* fromStream = SequenceSerializer<double>::LoadArraySequence(streamedInput);
+    EXPECT_EQ(fromStream->GetLength(), 3);
+    EXPECT_EQ(fromStream->Get(1), -2.5);
+    delete fromStream;
+
+    std::istringstream intact(bytes);
+    ArraySequence<double>* loaded = SequenceSerializer<double>::LoadArraySequence(intact);
+    EXPECT_EQ(loaded->Get(2), 3.25);
+    delete loaded;
+}
+
+TEST(MappedArraySequenceTest, ReadsSerializedFile) {
+    std::string path = testing::TempDir() + "mapped_sequence.bin";
+    ArraySequence<int> source;
+    for (int i = 0; i < 5000; ++i) {
+        source.Append(i - 2500);
+    }
+    {
+        std::ofstream file(path, std::ios::binary);
+        SequenceSerializer<int>::Save(source, file);
+    }
+
+    MappedArraySequence<int> mapped(path);
+    ASSERT_EQ(mapped.GetLength(), 5000);
+    EXPECT_TRUE(mapped.VerifyChecksum());
+    EXPECT_EQ(mapped.Get(0), -2500);
+    EXPECT_EQ(mapped.GetLast(), 2499);
+    EXPECT_THROW(mapped.Get(5000), IndexOutOfRangeException);
+    EXPECT_EQ(mapped.Reduce(add, 0), source.Reduce(add, 0));
+
+    Sequence<int>* squares = mapped.Map(square);
+    Sequence<int>* positives = mapped.Where(isPositive);
+    EXPECT_EQ(squares->Get(1), 2499 * 2499);
+    EXPECT_EQ(positives->GetLength(), 2499);
+    delete squares;
+    delete positives;
+
+    IEnumerator<int>* enumerator = mapped.GetEnumerator();
+    int count = 0;
+    while (enumerator->MoveNext()) {
+        EXPECT_EQ(enumerator->Current(), source.Get(count));
+        ++count;
+    }
+    EXPECT_EQ(count, 5000);
+
+    // Проходы перекрываются: второй перечислитель и Reduce при живом первом
+    enumerator->Reset();
+    IEnumerator<int>* second = mapped.GetEnumerator();
+    ASSERT_TRUE(enumerator->MoveNext());
+    ASSERT_TRUE(second->MoveNext());
+    EXPECT_EQ(mapped.Reduce(add, 0), source.Reduce(add, 0));
+    delete second;
+    ASSERT_TRUE(enumerator->MoveNext());
+    EXPECT_EQ(enumerator->Current(), -2499);
+    delete enumerator;
+
+    EXPECT_THROW(mapped.Append(1), InvalidOperationException);
+    EXPECT_THROW(mapped.Prepend(1), InvalidOperationException);
+    EXPECT_THROW(mapped.InsertAt(1, 0), InvalidOperationException);
+
+    EXPECT_THROW(MappedArraySequence<double> wrongType(path), SerializationException);
+    std::remove(path.c_str());
+}
+
+TEST(MappedArraySequenceTest, RejectsBadFiles) {
+    EXPECT_THROW(MappedArraySequence<int> missing(testing::TempDir() + "no_such_sequence.bin"), InvalidArgumentException);
+
+    std::string path = testing::TempDir() + "truncated_sequence.bin";
+    int data[] = {1, 2, 3};
+    ArraySequence<int> source(data, 3);
+    std::stringstream bytes;
+    SequenceSerializer<int>::Save(source, bytes);
+    {
+        std::ofstream file(path, std::ios::binary);
+        std::string content = bytes.str();
+        file.write(content.data(), static_cast<std::streamsize>(content.size() - 2));
+    }
+    EXPECT_THROW(MappedArraySequence<int> truncated(path), SerializationException);
+    std::remove(path.c_str());
+}
+
+TEST(SpillableSequenceTest, SpillsPagesBeyondBudget) {
+    const int pageSize = 256;
+    const long long budget = 4 * pageSize * sizeof(int);
+    EXPECT_THROW(SpillableSequence<int> missing(budget, pageSize, testing::TempDir() + "no_such_dir"),
+                 InvalidStateException);
+    SpillableSequence<int> seq(budget, pageSize, testing::TempDir());
+    for (int i = 0; i < 100000; ++i) {
+        seq.Append(i * 3);
+    }
+    ASSERT_EQ(seq.GetLength(), 100000);
+    EXPECT_GE(seq.GetSpilledBytes(), static_cast<long long>(99840 * sizeof(int)));
+    EXPECT_LE(seq.MemoryFootprint().payloadBytes + seq.MemoryFootprint().slackBytes, budget);
+
+    // Случайный доступ подгружает вытесненные страницы
+    EXPECT_EQ(seq.Get(0), 0);
+    EXPECT_EQ(seq.Get(54321), 54321 * 3);
+    EXPECT_EQ(seq.GetLast(), 99999 * 3);
+    EXPECT_GT(seq.GetStats().pageReads, 0);
+
+    IEnumerator<int>* enumerator = seq.GetEnumerator();
+    long long sum = 0;
+    int count = 0;
+    while (enumerator->MoveNext()) {
+        sum += enumerator->Current();
+        ++count;
+    }
+    delete enumerator;
+    EXPECT_EQ(count, 100000);
+    EXPECT_EQ(sum, 3LL * 99999 * 100000 / 2);
+    EXPECT_GT(seq.GetStats().prefetchHints, 0);
+
+    seq.Set(10, -1);
+    seq.InsertAt(7, 300);
+    seq.Prepend(5);
+    ASSERT_EQ(seq.GetLength(), 100002);
+    EXPECT_EQ(seq.Get(0), 5);
+    EXPECT_EQ(seq.Get(11), -1);
+    EXPECT_EQ(seq.Get(301), 7);
+    EXPECT_EQ(seq.Get(302), 300 * 3);
+    EXPECT_EQ(seq.GetLast(), 99999 * 3);
+}
+
+TEST(SpillableSequenceTest, TransformationsStaySpillable) {
+    SpillableSequence<int> seq(2 * 64 * sizeof(int), 64, testing::TempDir());
+    for (int i = -500; i < 500; ++i) {
+        seq.Append(i);
+    }
+    Sequence<int>* squares = seq.Map(square);
+    Sequence<int>* positives = seq.Where(isPositive);
+    EXPECT_NE(dynamic_cast<SpillableSequence<int>*>(squares), nullptr);
+    EXPECT_EQ(squares->Get(0), 250000);
+    EXPECT_EQ(positives->GetLength(), 499);
+    EXPECT_EQ(seq.Reduce(add, 0), -500);
+
+    Sequence<int>* joined = seq.Concat(positives);
+    EXPECT_EQ(joined->GetLength(), 1499);
+    EXPECT_EQ(joined->GetLast(), 499);
+
+    int replacement[] = {42, 43};
+    ArraySequence<int> inserted(replacement, 2);
+    Sequence<int>* sliced = seq.Slice(100, 800, &inserted);
+    ASSERT_EQ(sliced->GetLength(), 202);
+    EXPECT_EQ(sliced->Get(99), -401);
+    EXPECT_EQ(sliced->Get(100), 42);
+    EXPECT_EQ(sliced->Get(102), 400);
+
+    auto parts = seq.Split(isPositive);
+    EXPECT_EQ(parts.first->GetLength(), 499);
+    EXPECT_EQ(parts.second->GetLength(), 501);
+
+    Sequence<int>* middle = seq.GetSubsequence(250, 749);
+    EXPECT_EQ(middle->GetLength(), 500);
+    EXPECT_EQ(middle->GetFirst(), -250);
+
+    delete squares;
+    delete positives;
+    delete joined;
+    delete sliced;
+    delete parts.first;
+    delete parts.second;
+    delete middle;
+
+    EXPECT_THROW(SpillableSequence<int>(16, 64), InvalidArgumentException);
+    EXPECT_THROW(seq.Get(1000), IndexOutOfRangeException);
+}
+
+TEST(SpillableSequenceTest, DerivedResultsShareBudget) {
+    const int pageSize = 1024;
+    const long long budget = 4 * pageSize * sizeof(int);
+    SpillableSequence<int> seq(budget, pageSize, testing::TempDir());
+    for (int i = -20000; i < 20000; ++i) {
+        seq.Append(i);
+    }
+    Sequence<int>* squares = seq.Map(square);
+    auto parts = seq.Split(isPositive);
+    EXPECT_EQ(static_cast<SpillableSequence<int>*>(squares)->GetMemoryBudget(), budget);
+
+    // Результаты вытесняют страницы друг друга и источника, данные не теряются
+    EXPECT_EQ(squares->Get(0), 20000 * 20000);
+    EXPECT_EQ(squares->GetLast(), 19999 * 19999);
+    EXPECT_EQ(parts.first->GetLength(), 19999);
+    EXPECT_EQ(parts.second->GetLength(), 20001);
+    EXPECT_EQ(parts.first->GetFirst(), 1);
+    EXPECT_EQ(parts.second->GetLast(), 0);
+    EXPECT_EQ(seq.Get(12345), 12345 - 20000);
+    EXPECT_EQ(seq.Reduce(add, 0), -20000);
+
+    delete parts.first;
+    Sequence<int>* again = parts.second->Map(square);
+    EXPECT_EQ(again->GetFirst(), 20000 * 20000);
+    delete again;
+    delete parts.second;
+    delete squares;
+
+    // Одной страницы мало: источнику и результату нужно по кадру
+    EXPECT_THROW(SpillableSequence<int>(64 * sizeof(int), 64), InvalidArgumentException);
+}
+
+TEST(ExternalSortTest, MergesSpilledRuns) {
+    ArraySequence<int> input;
+    unsigned state = 7;
+    for (int i = 0; i < 300000; ++i) {
+        state = state * 1664525u + 1013904223u;
+        input.Append(static_cast<int>(state >> 8) - (1 << 23));
+    }
+
+    // 256 КБ: 65536 элементов на прогон и слияние не больше двух прогонов за проход
+    ExternalSorter<int> sorter(256 << 10, testing::TempDir());
+    sorter.Sort(input);
+    EXPECT_EQ(sorter.GetStats().initialRuns, 5);
+    EXPECT_GT(sorter.GetStats().mergePasses, 0);
+
+    ArraySequence<int>* sorted = sorter.ToArraySequence();
+    ASSERT_EQ(sorted->GetLength(), 300000);
+    // Эталон — std::sort той же выборки: совпадают и порядок, и сами элементы
+    DynamicArray<int> expected(input.GetData(), input.GetLength());
+    std::sort(expected.GetData(), expected.GetData() + expected.GetSize());
+    for (int i = 0; i < sorted->GetLength(); ++i) {
+        ASSERT_EQ(sorted->Get(i), expected[i]) << i;
+    }
+
+    // Перечислитель сливает заново при каждом проходе
+    IEnumerator<int>* enumerator = sorter.GetEnumerator();
+    for (int pass = 0; pass < 2; ++pass) {
+        int count = 0;
+        while (enumerator->MoveNext()) {
+            ASSERT_EQ(enumerator->Current(), sorted->Get(count));
+            ++count;
+        }
+        EXPECT_EQ(count, 300000);
+        enumerator->Reset();
+    }
+    delete enumerator;
+    delete sorted;
+}
+
+TEST(ExternalSortTest, CustomOrderAndSmallInputs) {
+    int data[] = {5, 1, 4, 1, 5, 9, 2, 6};
+    ListSequence<int> input(data, 8);
+    ExternalSorter<int, std::greater<int>> inMemory(1 << 20, testing::TempDir());
+    inMemory.Sort(input);
+    EXPECT_EQ(inMemory.GetStats().initialRuns, 0);
+    ArraySequence<int>* descending = inMemory.ToArraySequence();
+    int expected[] = {9, 6, 5, 5, 4, 2, 1, 1};
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(descending->Get(i), expected[i]);
+    }
+    delete descending;
+
+    // Бюджет на два элемента: четыре прогона на диске
+    ExternalSorter<int, std::greater<int>> tiny(2 * sizeof(int), testing::TempDir());
+    tiny.Sort(input);
+    EXPECT_EQ(tiny.GetStats().initialRuns, 4);
+    SpillableSequence<int>* spilled = tiny.ToSpillableSequence(1 << 20, 4);
+    ASSERT_EQ(spilled->GetLength(), 8);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(spilled->Get(i), expected[i]);
+    }
+    delete spilled;
+
+    ArraySequence<int> empty;
+    tiny.Sort(empty);
+    ArraySequence<int>* sortedEmpty = tiny.ToArraySequence();
+    EXPECT_EQ(sortedEmpty->GetLength(), 0);
+    delete sortedEmpty;
+
+    EXPECT_THROW(ExternalSorter<int>(0), InvalidArgumentException);
+}
+
+TEST(CompressedIntSequenceTest, EncodesBlocksLosslessly) {
+    // Отсортированные идентификаторы, узкий диапазон, полный диапазон и неполный последний блок
+    DynamicArray<int> ids(1000);
+    DynamicArray<int> counters(1000);
+    DynamicArray<int> wide(333);
+    unsigned state = 11;
+    for (int i = 0; i < 1000; ++i) {
+        state = state * 1664525u + 1013904223u;
+        ids[i] = 1000000 + i * 3 + static_cast<int>(state % 3);
+        counters[i] = -5 + static_cast<int>(state % 16);
+    }
+    for (int i = 0; i < 333; ++i) {
+        state = state * 1664525u + 1013904223u;
+        wide[i] = static_cast<int>(state);
+    }
+    wide[7] = INT_MIN;
+    wide[8] = INT_MAX;
+
+    const DynamicArray<int>* inputs[] = {&ids, &counters, &wide};
+    for (const DynamicArray<int>* input : inputs) {
+        CompressedIntSequence compressed(*input);
+        ASSERT_EQ(compressed.GetLength(), input->GetSize());
+        for (int i = 0; i < input->GetSize(); ++i) {
+            ASSERT_EQ(compressed.Get(i), (*input)[i]) << i;
+        }
+        IEnumerator<int>* enumerator = compressed.GetEnumerator();
+        for (int i = 0; enumerator->MoveNext(); ++i) {
+            ASSERT_EQ(enumerator->Current(), (*input)[i]);
+        }
+        delete enumerator;
+    }
+
+    CompressedIntSequence compressedIds(ids);
+    CompressedIntSequence compressedCounters(counters);
+    EXPECT_LT(compressedIds.GetBitsPerElement(), 3.1);
+    EXPECT_LT(compressedCounters.GetBitsPerElement(), 4.1);
+    EXPECT_LT(compressedIds.MemoryFootprint().payloadBytes, static_cast<long long>(1000 * sizeof(int)) / 8);
+
+    ArraySequence<int> source(counters);
+    CompressedIntSequence fromSequence(source);
+    EXPECT_EQ(fromSequence.Get(999), counters[999]);
+    EXPECT_THROW(fromSequence.Get(1000), IndexOutOfRangeException);
+}
+
+TEST(CompressedIntSequenceTest, BlockwiseOperations) {
+    DynamicArray<int> values(300);
+    for (int i = 0; i < 300; ++i) {
+        values[i] = i - 100;
+    }
+    CompressedIntSequence seq(values);
+    ArraySequence<int> plain(values);
+
+    EXPECT_EQ(seq.Reduce(add, 0), plain.Reduce(add, 0));
+    Option<int> found = seq.Find(isPositive);
+    ASSERT_TRUE(found.isSome());
+    EXPECT_EQ(found.getValue(), 1);
+
+    Sequence<int>* positives = seq.Where(isPositive);
+    Sequence<int>* squares = seq.Map(square);
+    Sequence<int>* middle = seq.GetSubsequence(120, 140);
+    Sequence<int>* sliced = seq.Slice(10, 280);
+    EXPECT_EQ(positives->GetLength(), 199);
+    EXPECT_EQ(squares->Get(0), 10000);
+    EXPECT_EQ(middle->GetLength(), 21);
+    EXPECT_EQ(middle->GetFirst(), 20);
+    EXPECT_EQ(sliced->GetLength(), 20);
+    EXPECT_EQ(sliced->Get(10), 190);
+    delete positives;
+    delete squares;
+    delete middle;
+    delete sliced;
+
+    ArraySequence<int>* restored = seq.Decompress();
+    EXPECT_EQ(restored->GetLength(), 300);
+    EXPECT_EQ(restored->GetLast(), 199);
+    delete restored;
+
+    EXPECT_THROW(seq.Append(1), InvalidOperationException);
+    CompressedIntSequence empty;
+    EXPECT_EQ(empty.GetLength(), 0);
+    EXPECT_FALSE(empty.Find(isPositive).isSome());
+}
+
+bool isDivisibleByThree(const int& x) { return x % 3 == 0; }
+bool negate(const bool& x) { return !x; }
+bool isTrue(const bool& x) { return x; }
+bool orBits(const bool& a, const bool& b) { return a || b; }
+
+TEST(BitSequenceTest, WordOperations) {
+    ArraySequence<int> numbers;
+    for (int i = 0; i < 200; ++i) {
+        numbers.Append(i);
+    }
+    BitSequence* even = BitSequence::FromPredicate<int>(numbers, isEven);
+    BitSequence* byThree = BitSequence::FromPredicate<int>(numbers, isDivisibleByThree);
+    ASSERT_EQ(even->GetLength(), 200);
+    EXPECT_EQ(even->CountOnes(), 100);
+    EXPECT_EQ(byThree->CountOnes(), 67);
+
+    BitSequence* both = even->And(*byThree);
+    BitSequence* either = even->Or(*byThree);
+    BitSequence* odd = even->Not();
+    EXPECT_EQ(both->CountOnes(), 34);
+    EXPECT_EQ(either->CountOnes(), 133);
+    EXPECT_EQ(odd->CountOnes(), 100);
+    EXPECT_EQ(odd->CountZeros(), 100);
+    EXPECT_EQ(both->FindNextSet(1), 6);
+    EXPECT_EQ(both->FindNextSet(193), 198);
+    EXPECT_EQ(both->FindNextSet(199), -1);
+    EXPECT_EQ(either->FindNextClear(2), 5);
+
+    Sequence<int>* selected = numbers.Where(*both);
+    ASSERT_EQ(selected->GetLength(), 34);
+    EXPECT_EQ(selected->Get(1), 6);
+    EXPECT_EQ(selected->GetLast(), 198);
+    delete selected;
+
+    ImmutableArraySequence<int> frozen(numbers);
+    Sequence<int>* frozenSelected = frozen.Where(*odd);
+    EXPECT_EQ(frozenSelected->GetFirst(), 1);
+    EXPECT_EQ(frozenSelected->GetLength(), 100);
+    delete frozenSelected;
+
+    BitSequence shorter(10, true);
+    EXPECT_THROW(even->And(shorter), InvalidSizeException);
+    EXPECT_THROW(numbers.Where(shorter), InvalidSizeException);
+
+    delete even;
+    delete byThree;
+    delete both;
+    delete either;
+    delete odd;
+}
+
+TEST(BitSequenceTest, SequenceInterface) {
+    bool pattern[] = {true, false, false, true, true};
+    BitSequence bits(pattern, 5);
+    bits.Prepend(false);
+    bits.InsertAt(true, 3);
+    // 0 1 0 1 0 1 1
+    for (int i = 0; i < 130; ++i) {
+        bits.Append(i % 5 == 0);
+    }
+    ASSERT_EQ(bits.GetLength(), 137);
+    EXPECT_FALSE(bits.GetFirst());
+    EXPECT_TRUE(bits.Get(1));
+    EXPECT_TRUE(bits.Get(3));
+    EXPECT_FALSE(bits.Get(4));
+    EXPECT_TRUE(bits.Get(6));
+    EXPECT_TRUE(bits.Get(7));
+    EXPECT_TRUE(bits.Get(132));
+    EXPECT_EQ(bits.CountOnes(), 4 + 26);
+
+    // Сдвиг через границу слов
+    bits.InsertAt(true, 2);
+    EXPECT_EQ(bits.GetLength(), 138);
+    EXPECT_TRUE(bits.Get(2));
+    EXPECT_TRUE(bits.Get(133));
+    EXPECT_FALSE(bits.Get(134));
+    bits.Set(133, false);
+    EXPECT_EQ(bits.CountOnes(), 30);
+
+    Sequence<bool>* negated = bits.Map(negate);
+    Sequence<bool>* ones = bits.Where(isTrue);
+    Sequence<bool>* middle = bits.GetSubsequence(60, 79);
+    Sequence<bool>* sliced = bits.Slice(1, 136);
+    Sequence<bool>* joined = bits.Concat(middle);
+    EXPECT_EQ(negated->Reduce(orBits, false), true);
+    EXPECT_FALSE(negated->Get(2));
+    EXPECT_EQ(ones->GetLength(), 30);
+    EXPECT_EQ(middle->GetLength(), 20);
+    EXPECT_TRUE(middle->Get(3));
+    EXPECT_EQ(sliced->GetLength(), 2);
+    EXPECT_EQ(joined->GetLength(), 158);
+    EXPECT_TRUE(joined->Get(141));
+    Option<bool> found = bits.Find(negate);
+    ASSERT_TRUE(found.isSome());
+    EXPECT_FALSE(found.getValue());
+
+    int enumerated = 0;
+    IEnumerator<bool>* enumerator = bits.GetEnumerator();
+    while (enumerator->MoveNext()) {
+        enumerated += enumerator->Current() ? 1 : 0;
+    }
+    delete enumerator;
+    EXPECT_EQ(enumerated, 30);
+    EXPECT_LE(bits.MemoryFootprint().payloadBytes, 18);
+
+    delete negated;
+    delete ones;
+    delete middle;
+    delete sliced;
+    delete joined;
+}
+
+TEST(SortedArraySequenceTest, RangeQueries) {
+    int values[] = {7, 3, 9, 3, 1, 7, 7, 12, 5};
+    SortedArraySequence<int> sorted(values, 9);
+    // 1 3 3 5 7 7 7 9 12
+    ASSERT_EQ(sorted.GetLength(), 9);
+    EXPECT_EQ(sorted.GetFirst(), 1);
+    EXPECT_EQ(sorted.GetLast(), 12);
+
+    const SearchLayout layouts[] = {SearchLayout::Sorted, SearchLayout::Eytzinger};
+    for (SearchLayout layout : layouts) {
+        sorted.SetSearchLayout(layout);
+        EXPECT_EQ(sorted.LowerBound(7), 4);
+        EXPECT_EQ(sorted.UpperBound(7), 7);
+        EXPECT_EQ(sorted.LowerBound(0), 0);
+        EXPECT_EQ(sorted.LowerBound(13), 9);
+        EXPECT_EQ(sorted.UpperBound(12), 9);
+        EXPECT_EQ(sorted.EqualRange(3), std::make_pair(1, 3));
+        EXPECT_EQ(sorted.EqualRange(4), std::make_pair(3, 3));
+        EXPECT_TRUE(sorted.Contains(9));
+        EXPECT_FALSE(sorted.Contains(8));
+        EXPECT_EQ(sorted.CountInRange(3, 7), 6);
+        EXPECT_EQ(sorted.CountInRange(8, 2), 0);
+        EXPECT_TRUE(sorted.FindValue(5).isSome());
+        EXPECT_FALSE(sorted.FindValue(6).isSome());
+    }
+
+    // Раскладка Эйтцингера против std::lower_bound на всех размерах дерева
+    for (int size = 0; size < 70; ++size) {
+        DynamicArray<int> items(size);
+        for (int i = 0; i < size; ++i) {
+            items[i] = i * 2;
+        }
+        SortedArraySequence<int> evens(items);
+        evens.SetSearchLayout(SearchLayout::Eytzinger);
+        for (int probe = -1; probe <= size * 2; ++probe) {
+            ASSERT_EQ(evens.LowerBound(probe), (probe + 1) / 2 < 0 ? 0 : (probe + 1) / 2) << size << " " << probe;
+        }
+    }
+
+    Option<int> positive = sorted.Find(isPositive);
+    ASSERT_TRUE(positive.isSome());
+    EXPECT_EQ(positive.getValue(), 1);
+}
+
+TEST(SortedArraySequenceTest, KeepsOrderOnUpdates) {
+    SortedArraySequence<int, std::greater<int>> descending;
+    descending.Add(5);
+    descending.Add(10);
+    descending.Add(1);
+    EXPECT_EQ(descending.Add(7), 1);
+    // 10 7 5 1
+    descending.Append(0);
+    descending.Prepend(20);
+    descending.InsertAt(6, 3);
+    EXPECT_THROW(descending.Append(3), InvalidArgumentException);
+    EXPECT_THROW(descending.InsertAt(8, 4), InvalidArgumentException);
+    ASSERT_EQ(descending.GetLength(), 7);
+    EXPECT_EQ(descending.Get(3), 6);
+    EXPECT_TRUE(descending.Remove(6));
+    EXPECT_FALSE(descending.Remove(6));
+
+    int batch[] = {8, 0, 15, 2, 7};
+    descending.Merge(batch, 5);
+    int expected[] = {20, 15, 10, 8, 7, 7, 5, 2, 1, 0, 0};
+    ASSERT_EQ(descending.GetLength(), 11);
+    for (int i = 0; i < 11; ++i) {
+        EXPECT_EQ(descending.Get(i), expected[i]) << i;
+    }
+    descending.SetSearchLayout(SearchLayout::Eytzinger);
+    EXPECT_EQ(descending.CountInRange(10, 2), 6);
+    descending.Add(9);
+    EXPECT_EQ(descending.LowerBound(9), 3);
+
+    ListSequence<int> list;
+    list.Append(4);
+    list.Append(-3);
+    SortedArraySequence<int> ascending(list);
+    ascending.Merge(list);
+    Sequence<int>* positives = ascending.Where(isPositive);
+    ASSERT_EQ(positives->GetLength(), 2);
+    EXPECT_NE(dynamic_cast<SortedArraySequence<int>*>(positives), nullptr);
+    Sequence<int>* tail = ascending.GetSubsequence(1, 3);
+    EXPECT_EQ(tail->GetFirst(), -3);
+    EXPECT_EQ(tail->GetLast(), 4);
+    delete positives;
+    delete tail;
+}
+
+TEST(SortedArraySequenceTest, ConcurrentEytzingerSearches) {
+    SortedArraySequence<int> sorted;
+    sorted.SetSearchLayout(SearchLayout::Eytzinger);
+    for (int i = 0; i < 4096; ++i) {
+        sorted.Add(2 * i);
+    }
+    // Раскладка уже построена изменением: поиски только читают
+    std::atomic<int> mismatches{0};
+    std::thread workers[4];
+    for (int t = 0; t < 4; ++t) {
+        workers[t] = std::thread([&sorted, &mismatches, t] {
+            for (int value = t; value < 8192; value += 4) {
+                if (sorted.LowerBound(value) != (value + 1) / 2) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(mismatches.load(), 0);
+
+    SortedArraySequence<int> copy(sorted);
+    EXPECT_EQ(copy.GetSearchLayout(), SearchLayout::Eytzinger);
+    EXPECT_EQ(copy.LowerBound(101), 51);
+    EXPECT_EQ(sorted.MemoryFootprint().overheadBytes, copy.MemoryFootprint().overheadBytes);
+    copy.SetSearchLayout(SearchLayout::Sorted);
+    EXPECT_EQ(copy.MemoryFootprint().overheadBytes, 0);
+}
+
+int lastDigit(const std::pair<int, int>& p) { return p.first % 10; }
+std::string decimalKey(const std::pair<int, int>& p) { return std::to_string(p.first % 100); }
+
+TEST(SortTest, MatchesStandardSort) {
+    const int count = 100000;
+    DynamicArray<int> ints(count);
+    DynamicArray<double> doubles(count);
+    DynamicArray<std::string> strings(count);
+    unsigned state = 5;
+    for (int i = 0; i < count; ++i) {
+        state = state * 1664525u + 1013904223u;
+        ints[i] = static_cast<int>(state);
+        doubles[i] = (static_cast<int>(state % 20001) - 10000) / 7.0;
+        strings[i] = std::to_string(state % 5000);
+    }
+    ints[0] = INT_MIN;
+    ints[1] = INT_MAX;
+
+    ArraySequence<int> intSeq(ints);
+    ArraySequence<double> doubleSeq(doubles);
+    ArraySequence<std::string> stringSeq(strings);
+    intSeq.Sort();
+    doubleSeq.Sort();
+    stringSeq.Sort(std::greater<std::string>());
+    std::sort(ints.GetData(), ints.GetData() + count);
+    std::sort(doubles.GetData(), doubles.GetData() + count);
+    std::sort(strings.GetData(), strings.GetData() + count, std::greater<std::string>());
+    for (int i = 0; i < count; ++i) {
+        ASSERT_EQ(intSeq.Get(i), ints[i]) << i;
+        ASSERT_EQ(doubleSeq.Get(i), doubles[i]) << i;
+        ASSERT_EQ(stringSeq.Get(i), strings[i]) << i;
+    }
+
+    int small[] = {3, -1, 2, -1, 0};
+    ArraySequence<int> smallSeq(small, 5);
+    smallSeq.StableSort();
+    EXPECT_EQ(smallSeq.GetFirst(), -1);
+    EXPECT_EQ(smallSeq.GetLast(), 3);
+    ArraySequence<int> empty;
+    empty.Sort();
+    EXPECT_EQ(empty.GetLength(), 0);
+
+    ImmutableArraySequence<int> frozen(small, 5);
+    EXPECT_THROW(frozen.Sort(), InvalidOperationException);
+    EXPECT_THROW(frozen.SortBy(square), InvalidOperationException);
+    EXPECT_EQ(frozen.GetFirst(), 3);
+}
+
+TEST(SortTest, StableVariantsKeepOrder) {
+    // second — исходная позиция: среди равных ключей она должна возрастать
+    const int count = 70000;
+    DynamicArray<std::pair<int, int>> items(count);
+    unsigned state = 9;
+    for (int i = 0; i < count; ++i) {
+        state = state * 1664525u + 1013904223u;
+        items[i] = std::make_pair(static_cast<int>(state % 1000), i);
+    }
+
+    ArraySequence<std::pair<int, int>> byFirst(items);
+    byFirst.StableSort([](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; });
+    ArraySequence<std::pair<int, int>> byDigit(items);
+    byDigit.SortBy(lastDigit);
+    ArraySequence<std::pair<int, int>> byText(items);
+    byText.SortBy(decimalKey);
+
+    for (int i = 1; i < count; ++i) {
+        std::pair<int, int> previous = byFirst.Get(i - 1);
+        std::pair<int, int> current = byFirst.Get(i);
+        ASSERT_TRUE(previous.first < current.first ||
+                    (previous.first == current.first && previous.second < current.second)) << i;
+
+        previous = byDigit.Get(i - 1);
+        current = byDigit.Get(i);
+        ASSERT_TRUE(lastDigit(previous) < lastDigit(current) ||
+                    (lastDigit(previous) == lastDigit(current) && previous.second < current.second)) << i;
+
+        previous = byText.Get(i - 1);
+        current = byText.Get(i);
+        ASSERT_TRUE(decimalKey(previous) < decimalKey(current) ||
+                    (decimalKey(previous) == decimalKey(current) && previous.second < current.second)) << i;
+    }
+
+    // Поразрядная сортировка с нагрузкой напрямую
+    long long keys[] = {5, -7, 5, 1LL << 40, -7};
+    int payload[] = {0, 1, 2, 3, 4};
+    RadixSortWithPayload(keys, payload, 5);
+    EXPECT_EQ(keys[0], -7);
+    EXPECT_EQ(payload[0], 1);
+    EXPECT_EQ(payload[1], 4);
+    EXPECT_EQ(payload[2], 0);
+    EXPECT_EQ(keys[4], 1LL << 40);
+}
+
+TEST(SelectionTest, TopKOverArraysAndLists) {
+    const int count = 100000;
+    DynamicArray<int> values(count);
+    unsigned state = 17;
+    for (int i = 0; i < count; ++i) {
+        state = state * 1664525u + 1013904223u;
+        values[i] = static_cast<int>(state % 1000000);
+    }
+    DynamicArray<int> sorted(values);
+    std::sort(sorted.GetData(), sorted.GetData() + count);
+
+    ArraySequence<int> array(values);
+    ArraySequence<int>* largest = TopK(array, 100);
+    ASSERT_EQ(largest->GetLength(), 100);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(largest->Get(i), sorted[count - 1 - i]) << i;
+    }
+    ArraySequence<int>* smallest = TopK(array, 10, std::greater<int>());
+    EXPECT_EQ(smallest->GetFirst(), sorted[0]);
+    EXPECT_EQ(smallest->GetLast(), sorted[9]);
+    delete largest;
+    delete smallest;
+
+    ListSequence<int> list;
+    int items[] = {4, 9, -2, 9, 7};
+    for (int item : items) {
+        list.Append(item);
+    }
+    ArraySequence<int>* top = TopK(list, 3);
+    ASSERT_EQ(top->GetLength(), 3);
+    EXPECT_EQ(top->Get(0), 9);
+    EXPECT_EQ(top->Get(1), 9);
+    EXPECT_EQ(top->Get(2), 7);
+    ArraySequence<int>* all = TopK(list, 10);
+    EXPECT_EQ(all->GetLength(), 5);
+    EXPECT_EQ(all->GetLast(), -2);
+    ArraySequence<int>* none = TopK(list, 0);
+    EXPECT_EQ(none->GetLength(), 0);
+    EXPECT_THROW(TopK(list, -1), InvalidArgumentException);
+    delete top;
+    delete all;
+    delete none;
+}
+
+TEST(SelectionTest, NthElementAndMedian) {
+    int items[] = {9, 1, 8, 2, 7, 3, 6, 4, 5};
+    ArraySequence<int> seq(items, 9);
+    EXPECT_EQ(seq.Median(), 5);
+    EXPECT_EQ(seq.NthElement(0), 1);
+    EXPECT_EQ(seq.NthElement(8), 9);
+    EXPECT_EQ(seq.NthElement(2, std::greater<int>()), 7);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_GE(seq.Get(i), 7);
+    }
+    for (int i = 3; i < 9; ++i) {
+        EXPECT_LE(seq.Get(i), 7);
+    }
+
+    seq.Append(10);
+    EXPECT_EQ(seq.Median(), 5);
+    EXPECT_THROW(seq.NthElement(10), IndexOutOfRangeException);
+    ArraySequence<int> empty;
+    EXPECT_THROW(empty.Median(), EmptySequenceException);
+    ImmutableArraySequence<int> frozen(items, 9);
+    EXPECT_THROW(frozen.Median(), InvalidOperationException);
+}
+
+TEST(HashIndexTest, LookupsMatchLinearScan) {
+    ArraySequence<int> seq;
+    unsigned state = 23;
+    for (int i = 0; i < 5000; ++i) {
+        state = state * 1664525u + 1013904223u;
+        seq.Append(static_cast<int>(state % 3000));
+    }
+    ArraySequence<int> plain(seq);
+    seq.EnableHashIndex();
+    ASSERT_TRUE(seq.HasHashIndex());
+    EXPECT_FALSE(plain.HasHashIndex());
+    EXPECT_GT(seq.MemoryFootprint().overheadBytes, 0);
+
+    // Вставки в начало, середину и конец сдвигают позиции в индексе
+    seq.Prepend(2999);
+    seq.InsertAt(-5, 2500);
+    seq.Append(7000);
+    seq.InsertAt(-5, 10);
+    plain.Prepend(2999);
+    plain.InsertAt(-5, 2500);
+    plain.Append(7000);
+    plain.InsertAt(-5, 10);
+    for (int value = -10; value < 3010; ++value) {
+        ASSERT_EQ(seq.IndexOf(value), plain.IndexOf(value)) << value;
+        ASSERT_EQ(seq.CountOf(value), plain.CountOf(value)) << value;
+    }
+    EXPECT_EQ(seq.IndexOf(-5), 10);
+    EXPECT_EQ(seq.CountOf(-5), 2);
+    EXPECT_EQ(seq.IndexOf(7000), seq.GetLength() - 1);
+    EXPECT_TRUE(seq.Contains(2999));
+    EXPECT_FALSE(seq.Contains(-1));
+    Option<int> found = seq.FindValue(7000);
+    ASSERT_TRUE(found.isSome());
+    EXPECT_EQ(found.getValue(), 7000);
+    EXPECT_FALSE(seq.FindValue(-1).isSome());
+
+    double fractions[] = {0.5, 0.0, 2.5};
+    ArraySequence<double> doubles(fractions, 3);
+    EXPECT_TRUE(doubles.FindValue(0).isSome());
+    EXPECT_FALSE(doubles.FindValue(1).isSome());
+
+    seq.Sort();
+    EXPECT_EQ(seq.IndexOf(-5), 0);
+    EXPECT_EQ(seq.IndexOf(7000), seq.GetLength() - 1);
+
+    seq.DisableHashIndex();
+    EXPECT_FALSE(seq.HasHashIndex());
+    EXPECT_EQ(seq.IndexOf(-5), 0);
+}
+
+TEST(HashIndexTest, DerivedSequencesKeepIndex) {
+    int items[] = {5, 3, 5, 8, 1};
+    ArraySequence<int> seq(items, 5);
+    seq.EnableHashIndex();
+
+    ArraySequence<int>* sliced = static_cast<ArraySequence<int>*>(seq.Slice(1, 2));
+    // 5 8 1
+    ASSERT_TRUE(sliced->HasHashIndex());
+    EXPECT_EQ(sliced->IndexOf(8), 1);
+    EXPECT_EQ(sliced->IndexOf(3), -1);
+    delete sliced;
+
+    ArraySequence<int> copy(seq);
+    copy.Append(9);
+    EXPECT_EQ(copy.IndexOf(9), 5);
+    EXPECT_EQ(seq.IndexOf(9), -1);
+    copy = seq;
+    EXPECT_EQ(copy.IndexOf(9), -1);
+
+    ImmutableArraySequence<std::string> names;
+    names.EnableHashIndex();
+    ImmutableArraySequence<std::string>* one = names.AppendNew("b");
+    ImmutableArraySequence<std::string>* two = one->PrependNew("a");
+    ImmutableArraySequence<std::string>* three = two->InsertAtNew("c", 1);
+    // a c b
+    ASSERT_TRUE(three->HasHashIndex());
+    EXPECT_EQ(one->IndexOf("b"), 0);
+    EXPECT_EQ(three->IndexOf("b"), 2);
+    EXPECT_EQ(three->IndexOf("c"), 1);
+    EXPECT_TRUE(three->Contains("a"));
+
+    // Повтор в начале: первая позиция сдвигается, у исходной копии индекс прежний
+    ImmutableArraySequence<std::string>* repeated = two->PrependNew("b");
+    EXPECT_EQ(repeated->IndexOf("b"), 0);
+    EXPECT_EQ(repeated->CountOf("b"), 2);
+    EXPECT_EQ(repeated->IndexOf("a"), 1);
+    EXPECT_EQ(two->IndexOf("b"), 1);
+    delete one;
+    delete two;
+    delete three;
+    delete repeated;
+}
+
+// Сверка с MemoryTracker — в DiagnosticsTests, где учёт памяти включён всегда
+TEST(MemoryTest, Footprint) {
+    ArraySequence<int> array;
+    for (int i = 0; i < 5; ++i) {
+        array.Append(i);
+    }
+    MemoryUsage arrayUsage = array.MemoryFootprint();
+    EXPECT_EQ(arrayUsage.payloadBytes, static_cast<long long>(5 * sizeof(int)));
+    EXPECT_EQ(arrayUsage.slackBytes, static_cast<long long>(3 * sizeof(int)));
+    EXPECT_EQ(arrayUsage.overheadBytes, 0);
+
+    int data[] = {1, 2, 3};
+    ListSequence<int> list(data, 3);
+    MemoryUsage listUsage = list.MemoryFootprint();
+    EXPECT_EQ(listUsage.payloadBytes, static_cast<long long>(3 * sizeof(int)));
+    EXPECT_EQ(listUsage.overheadBytes, static_cast<long long>(3 * (sizeof(Node<int>) - sizeof(int))));
+}
+
 // Тесты для Slice
 TEST(ArraySequenceTest, SliceBasic) {
     int data[] = {1, 2, 3, 4, 5};
@@ -771,6 +2050,49 @@ TEST(ArraySequenceTest, FlatMapEdgeCases) {
     delete result;
 }
 
+void repeatIntoSink(const int& x, ISequenceSink<int>& sink) {
+    for (int i = 0; i < x % 4; ++i) {
+        sink.Push(x);
+    }
+}
+
+TEST(ArraySequenceTest, FlatMapIntoSink) {
+    int data[] = {1, 2, 3, 4};
+    ArraySequence<int> seq(data, 4);
+    Sequence<int>* result = seq.FlatMap(repeatIntoSink);
+    int expected[] = {1, 2, 2, 3, 3, 3};
+    ASSERT_EQ(result->GetLength(), 6);
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(result->Get(i), expected[i]);
+    }
+    delete result;
+
+    ListSequence<int> list(data, 4);
+    result = list.FlatMap(repeatIntoSink);
+    ASSERT_EQ(result->GetLength(), 6);
+    EXPECT_EQ(result->Get(5), 3);
+    delete result;
+}
+
+TEST(ArraySequenceTest, ParallelFlatMapMatchesSequential) {
+    const int count = 100000;
+    DynamicArray<int> items(count);
+    for (int i = 0; i < count; ++i) {
+        items[i] = i;
+    }
+    ImmutableArraySequence<int> seq(std::move(items));
+
+    Sequence<int>* sequential = seq.FlatMap(repeatIntoSink);
+    Sequence<int>* parallel = seq.ParallelFlatMap(repeatIntoSink);
+    EXPECT_NE(dynamic_cast<ImmutableArraySequence<int>*>(parallel), nullptr);
+    ASSERT_EQ(parallel->GetLength(), sequential->GetLength());
+    for (int i = 0; i < parallel->GetLength(); ++i) {
+        ASSERT_EQ(parallel->Get(i), sequential->Get(i));
+    }
+    delete sequential;
+    delete parallel;
+}
+
 TEST(ArraySequenceTest, FindAndSplitEdgeCases) {
     ArraySequence<int> seq;
     
@@ -794,6 +2116,42 @@ TEST(ArraySequenceTest, FindAndSplitEdgeCases) {
     delete none;
 }
 
+TEST(ArraySequenceTest, SplitLargeIsStable) {
+    const int count = 100000;
+    DynamicArray<int> items(count);
+    for (int i = 0; i < count; ++i) {
+        items[i] = (i * 7919) % count;
+    }
+    ArraySequence<int> large(std::move(items));
+
+    auto [even, odd] = large.Split(isEven);
+    EXPECT_EQ(even->GetLength() + odd->GetLength(), count);
+
+    // Порядок внутри каждой части совпадает с исходным
+    int evenIndex = 0;
+    int oddIndex = 0;
+    for (int i = 0; i < count; ++i) {
+        int value = large.Get(i);
+        if (isEven(value)) {
+            EXPECT_EQ(even->Get(evenIndex++), value);
+        } else {
+            EXPECT_EQ(odd->Get(oddIndex++), value);
+        }
+    }
+    EXPECT_EQ(evenIndex, even->GetLength());
+    EXPECT_EQ(oddIndex, odd->GetLength());
+    delete even;
+    delete odd;
+
+    ImmutableArraySequence<int> immutable(large);
+    auto [immEven, immOdd] = immutable.Split(isEven);
+    EXPECT_NE(dynamic_cast<ImmutableArraySequence<int>*>(immEven), nullptr);
+    EXPECT_EQ(immEven->GetLength() + immOdd->GetLength(), count);
+    EXPECT_THROW(immEven->Append(1), InvalidOperationException);
+    delete immEven;
+    delete immOdd;
+}
+
 // Тесты для иммутабельных последовательностей
 TEST(ImmutableArraySequenceTest, ImmutabilityCheck) {
     int data[] = {1, 2, 3};